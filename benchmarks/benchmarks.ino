@@ -25,6 +25,8 @@
 #include <array>
 #include <numeric>
 #include <LED_Matrix_Graphics.h>
+#include <LMG_CurrentLimiter.h>
+#include <LMG_NumberDisplay.h>
 
 LMG::Frame frame {};
 constexpr uint8_t TOTAL_LED_COUNT {
@@ -39,6 +41,24 @@ constexpr std::array<uint32_t, 3> FILL_RECT_SAMPLES{100, 1000, 10000};
 constexpr uint32_t FILL_RECT_RUNS{10};
 constexpr std::array<uint32_t, 3> INVERT_RECT_SAMPLES{100, 1000, 10000};
 constexpr uint32_t INVERT_RECT_RUNS{10};
+constexpr std::array<uint32_t, 3> SET_LEDS_SAMPLES{100, 1000, 10000};
+constexpr uint32_t SET_LEDS_RUNS{10};
+constexpr size_t SET_LEDS_BATCH{32};
+constexpr std::array<uint32_t, 3> GET_ROW_SAMPLES{1000, 10000, 100000};
+constexpr uint32_t GET_ROW_RUNS{10};
+constexpr std::array<uint32_t, 3> GET_COLUMN_SAMPLES{1000, 10000, 100000};
+constexpr uint32_t GET_COLUMN_RUNS{10};
+constexpr std::array<uint32_t, 3> DILATE_SAMPLES{100, 1000, 10000};
+constexpr uint32_t DILATE_RUNS{10};
+constexpr std::array<uint32_t, 3> FLOOD_FILL_SAMPLES{100, 1000, 10000};
+constexpr uint32_t FLOOD_FILL_RUNS{10};
+constexpr std::array<uint32_t, 3> COPY_REGION_SAMPLES{100, 1000, 10000};
+constexpr uint32_t COPY_REGION_RUNS{10};
+constexpr std::array<uint32_t, 3> CURRENT_LIMIT_SAMPLES{100, 1000, 10000};
+constexpr uint32_t CURRENT_LIMIT_RUNS{10};
+constexpr uint8_t CURRENT_LIMIT_BUDGET{12};
+constexpr std::array<uint32_t, 3> NUMBER_DISPLAY_SAMPLES{1000, 10000, 100000};
+constexpr uint32_t NUMBER_DISPLAY_RUNS{10};
 
 /// Prints the results of a benchmark.
 /**
@@ -243,12 +263,436 @@ void runBenchmarksInvertRect() {
   }
 }
 
+/// How the points are plotted in the batch plotting benchmark.
+enum class BatchMethod { SetLEDLoop, SetLEDs, SetLEDsLinear };
+
+/// Runs a single benchmark for Frame::setLEDs, or for the equivalent loop of
+/// Frame::setLED calls. The result is the time per plotted point.
+const std::tuple<double, double> timeSetLEDs(const uint32_t iterations,
+                                             const BatchMethod method) {
+  std::array<double, SET_LEDS_RUNS> times {};
+
+  // The points are generated ahead of time, so that only plotting is timed.
+  std::array<int8_t, SET_LEDS_BATCH> rows {};
+  std::array<int8_t, SET_LEDS_BATCH> cols {};
+  std::array<uint8_t, SET_LEDS_BATCH> positions {};
+  for (size_t i = 0; i < SET_LEDS_BATCH; i++) {
+    rows[i] = rand() % LMG::LED_MATRIX_HEIGHT;
+    cols[i] = rand() % LMG::LED_MATRIX_WIDTH;
+    positions[i] = rows[i] * LMG::LED_MATRIX_WIDTH + cols[i];
+  }
+
+  for (uint32_t run = 0; run < SET_LEDS_RUNS; run++) {
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      switch (method) {
+      case BatchMethod::SetLEDLoop:
+        for (size_t i = 0; i < SET_LEDS_BATCH; i++) {
+          frame.setLED(rows[i], cols[i], true);
+        }
+        break;
+      case BatchMethod::SetLEDs:
+        frame.setLEDs(rows.data(), cols.data(), SET_LEDS_BATCH,
+                      LMG::PlotMode::Set);
+        break;
+      case BatchMethod::SetLEDsLinear:
+        frame.setLEDs(positions.data(), SET_LEDS_BATCH, LMG::PlotMode::Set);
+        break;
+      }
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per point in microseconds
+    const double per_point =
+        total / static_cast<double>(iterations * SET_LEDS_BATCH);
+    times[run] = per_point;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for Frame::setLEDs and prints the per-point results
+/// over serial.
+void runBenchmarksSetLEDs() {
+  Serial.print("Running benchmarks for a loop of Frame::setLED!\n");
+  for (auto sample_size : SET_LEDS_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeSetLEDs(sample_size, BatchMethod::SetLEDLoop);
+    printResults(result, sample_size, SET_LEDS_RUNS);
+  }
+  Serial.print("Running benchmarks for Frame::setLEDs with rows and cols!\n");
+  for (auto sample_size : SET_LEDS_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeSetLEDs(sample_size, BatchMethod::SetLEDs);
+    printResults(result, sample_size, SET_LEDS_RUNS);
+  }
+  Serial.print("Running benchmarks for Frame::setLEDs with positions!\n");
+  for (auto sample_size : SET_LEDS_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeSetLEDs(sample_size, BatchMethod::SetLEDsLinear);
+    printResults(result, sample_size, SET_LEDS_RUNS);
+  }
+}
+
+/// Runs a single benchmark for Frame::getRow.
+const std::tuple<double, double> timeGetRow(const uint32_t iterations) {
+  std::array<double, GET_ROW_RUNS> times {};
+  for (uint32_t run = 0; run < GET_ROW_RUNS; run++) {
+    volatile uint16_t consumer {};
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      consumer = frame.getRow(count % LMG::LED_MATRIX_HEIGHT);
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for Frame::getRow and prints the results over serial.
+void runBenchmarksGetRow() {
+  Serial.print("Running benchmarks for Frame::getRow!\n");
+  for (auto sample_size : GET_ROW_SAMPLES) {
+    const std::tuple<double, double> result = timeGetRow(sample_size);
+    printResults(result, sample_size, GET_ROW_RUNS);
+  }
+}
+
+/// Runs a single benchmark for Frame::getColumn.
+const std::tuple<double, double> timeGetColumn(const uint32_t iterations) {
+  std::array<double, GET_COLUMN_RUNS> times {};
+  for (uint32_t run = 0; run < GET_COLUMN_RUNS; run++) {
+    volatile uint8_t consumer {};
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      consumer = frame.getColumn(count % LMG::LED_MATRIX_WIDTH);
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for Frame::getColumn and prints the results over
+/// serial.
+void runBenchmarksGetColumn() {
+  Serial.print("Running benchmarks for Frame::getColumn!\n");
+  for (auto sample_size : GET_COLUMN_SAMPLES) {
+    const std::tuple<double, double> result = timeGetColumn(sample_size);
+    printResults(result, sample_size, GET_COLUMN_RUNS);
+  }
+}
+
+/// Starting pattern for the morphology benchmarks: the border of the matrix
+/// and a diagonal line through the middle.
+bool morphology_pattern[LMG::LED_MATRIX_HEIGHT][LMG::LED_MATRIX_WIDTH] {};
+
+/// Fills morphology_pattern and returns a frame with the same contents.
+LMG::Frame makeMorphologyPattern() {
+  LMG::Frame pattern {};
+  for (int8_t row = 0; row < LMG::LED_MATRIX_HEIGHT; row++) {
+    for (int8_t col = 0; col < LMG::LED_MATRIX_WIDTH; col++) {
+      const bool border = row == 0 || col == 0 ||
+                          row == LMG::LED_MATRIX_HEIGHT - 1 ||
+                          col == LMG::LED_MATRIX_WIDTH - 1;
+      morphology_pattern[row][col] = border || row + 2 == col;
+      pattern.setLED(row, col, morphology_pattern[row][col]);
+    }
+  }
+  return pattern;
+}
+
+/// Per-pixel dilation of morphology_pattern, used as a point of comparison.
+LMG::Frame naiveDilate() {
+  LMG::Frame result {};
+  for (int8_t row = 0; row < LMG::LED_MATRIX_HEIGHT; row++) {
+    for (int8_t col = 0; col < LMG::LED_MATRIX_WIDTH; col++) {
+      bool lit = false;
+      for (int8_t d_row = -1; d_row <= 1; d_row++) {
+        for (int8_t d_col = -1; d_col <= 1; d_col++) {
+          const int8_t r = row + d_row;
+          const int8_t c = col + d_col;
+          if (r >= 0 && r < LMG::LED_MATRIX_HEIGHT && c >= 0 &&
+              c < LMG::LED_MATRIX_WIDTH && morphology_pattern[r][c]) {
+            lit = true;
+          }
+        }
+      }
+      result.setLED(row, col, lit);
+    }
+  }
+  return result;
+}
+
+/// Runs a single benchmark for Frame::dilate, or for the per-pixel version
+/// if `naive` is true.
+const std::tuple<double, double> timeDilate(const uint32_t iterations,
+                                            const bool naive) {
+  std::array<double, DILATE_RUNS> times {};
+  const LMG::Frame pattern = makeMorphologyPattern();
+  for (uint32_t run = 0; run < DILATE_RUNS; run++) {
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      if (naive) {
+        frame = naiveDilate();
+      } else {
+        frame = pattern;
+        frame.dilate();
+      }
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for Frame::dilate and prints the results over serial.
+void runBenchmarksDilate() {
+  Serial.print("Running benchmarks for Frame::dilate!\n");
+  for (auto sample_size : DILATE_SAMPLES) {
+    const std::tuple<double, double> result = timeDilate(sample_size, false);
+    printResults(result, sample_size, DILATE_RUNS);
+  }
+  Serial.print("Running benchmarks for per-pixel dilation!\n");
+  for (auto sample_size : DILATE_SAMPLES) {
+    const std::tuple<double, double> result = timeDilate(sample_size, true);
+    printResults(result, sample_size, DILATE_RUNS);
+  }
+}
+
+/// Runs a single benchmark for Frame::floodFill.
+const std::tuple<double, double> timeFloodFill(const uint32_t iterations) {
+  std::array<double, FLOOD_FILL_RUNS> times {};
+  const LMG::Frame pattern = makeMorphologyPattern();
+  for (uint32_t run = 0; run < FLOOD_FILL_RUNS; run++) {
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      frame = pattern;
+      frame.floodFill(5, 1);
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for Frame::floodFill and prints the results over
+/// serial.
+void runBenchmarksFloodFill() {
+  Serial.print("Running benchmarks for Frame::floodFill!\n");
+  for (auto sample_size : FLOOD_FILL_SAMPLES) {
+    const std::tuple<double, double> result = timeFloodFill(sample_size);
+    printResults(result, sample_size, FLOOD_FILL_RUNS);
+  }
+}
+
+/// Runs a single benchmark for Frame::copyRegion.
+const std::tuple<double, double> timeCopyRegion(const uint32_t iterations) {
+  std::array<double, COPY_REGION_RUNS> times {};
+  const LMG::Frame pattern = makeMorphologyPattern();
+  const LMG::Rect areas[] = {{0, 7, 0, 2}, {5, 7, 0, 11}, {1, 3, 6, 9}};
+  const LMG::Region region{areas, 3};
+  for (uint32_t run = 0; run < COPY_REGION_RUNS; run++) {
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      frame.copyRegion(pattern, region);
+      frame.invertRegion(region);
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for Frame::copyRegion and prints the results over
+/// serial.
+void runBenchmarksCopyRegion() {
+  Serial.print("Running benchmarks for Frame::copyRegion!\n");
+  for (auto sample_size : COPY_REGION_SAMPLES) {
+    const std::tuple<double, double> result = timeCopyRegion(sample_size);
+    printResults(result, sample_size, COPY_REGION_RUNS);
+  }
+}
+
+/// Per-pixel version of CurrentLimiter::subFrame, used as a point of
+/// comparison. Every `count`-th lit LED goes into the sub-frame.
+LMG::Frame naiveSubFrame(const LMG::Frame &source, const uint8_t count,
+                         const uint8_t index) {
+  LMG::Frame result {};
+  uint8_t rank = 0;
+  for (int8_t row = 0; row < LMG::LED_MATRIX_HEIGHT; row++) {
+    for (int8_t col = 0; col < LMG::LED_MATRIX_WIDTH; col++) {
+      if (source.getLED(row, col)) {
+        result.setLED(row, col, rank % count == index);
+        rank++;
+      }
+    }
+  }
+  return result;
+}
+
+/// Runs a single benchmark for CurrentLimiter::present, or for the per-pixel
+/// version if `naive` is true.
+const std::tuple<double, double> timeCurrentLimit(const uint32_t iterations,
+                                                  const bool naive) {
+  std::array<double, CURRENT_LIMIT_RUNS> times {};
+  const LMG::Frame pattern = makeMorphologyPattern();
+  LMG::CurrentLimiter limiter{CURRENT_LIMIT_BUDGET};
+  for (uint32_t run = 0; run < CURRENT_LIMIT_RUNS; run++) {
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      limiter.setFrame(pattern);
+      if (naive) {
+        const uint8_t sub_frames = limiter.subFrameCount();
+        frame = naiveSubFrame(pattern, sub_frames, count % sub_frames);
+      } else {
+        frame = limiter.present();
+      }
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for CurrentLimiter and prints the results over serial.
+void runBenchmarksCurrentLimit() {
+  Serial.print("Running benchmarks for CurrentLimiter::present!\n");
+  for (auto sample_size : CURRENT_LIMIT_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeCurrentLimit(sample_size, false);
+    printResults(result, sample_size, CURRENT_LIMIT_RUNS);
+  }
+  Serial.print("Running benchmarks for per-pixel sub-frames!\n");
+  for (auto sample_size : CURRENT_LIMIT_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeCurrentLimit(sample_size, true);
+    printResults(result, sample_size, CURRENT_LIMIT_RUNS);
+  }
+}
+
+/// Runs a single benchmark for NumberDisplay::draw, or for redrawing every
+/// digit with drawSprite if `naive` is true. The value advances every 100
+/// iterations, like a stopwatch that is updated in a tight loop.
+const std::tuple<double, double> timeNumberDisplay(const uint32_t iterations,
+                                                   const bool naive) {
+  std::array<double, NUMBER_DISPLAY_RUNS> times {};
+  constexpr size_t DIGITS_OFFSET{29};
+  const int8_t columns[] = {0, 4, 9};
+  LMG::NumberDisplay display{1, columns, 3};
+  for (uint32_t run = 0; run < NUMBER_DISPLAY_RUNS; run++) {
+    const uint32_t start_time = micros();
+    for (uint32_t count = 0; count < iterations; count++) {
+      const uint32_t value = (count / 100) % 1000;
+      if (naive) {
+        frame.drawSprite(LMG::DEFAULT_FONT_3x5[DIGITS_OFFSET + value / 100],
+                         LMG::Rect(1, 5, 0, 2));
+        frame.drawSprite(
+            LMG::DEFAULT_FONT_3x5[DIGITS_OFFSET + (value / 10) % 10],
+            LMG::Rect(1, 5, 4, 6));
+        frame.drawSprite(LMG::DEFAULT_FONT_3x5[DIGITS_OFFSET + value % 10],
+                         LMG::Rect(1, 5, 9, 11));
+      } else {
+        display.setValue(value);
+        display.draw(frame);
+      }
+    }
+    const uint32_t final_time = micros();
+
+    // Time in microseconds
+    const double total = static_cast<double>(
+      final_time - start_time);
+
+    // Time per iteration in microseconds
+    const double per_iter = total / static_cast<double>(iterations);
+    times[run] = per_iter;
+  }
+
+  return getStats(times);
+}
+
+/// Runs all benchmarks for NumberDisplay and prints the results over serial.
+void runBenchmarksNumberDisplay() {
+  Serial.print("Running benchmarks for NumberDisplay::draw!\n");
+  for (auto sample_size : NUMBER_DISPLAY_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeNumberDisplay(sample_size, false);
+    printResults(result, sample_size, NUMBER_DISPLAY_RUNS);
+  }
+  Serial.print("Running benchmarks for redrawing digits with drawSprite!\n");
+  for (auto sample_size : NUMBER_DISPLAY_SAMPLES) {
+    const std::tuple<double, double> result =
+        timeNumberDisplay(sample_size, true);
+    printResults(result, sample_size, NUMBER_DISPLAY_RUNS);
+  }
+}
+
 void setup() {
   Serial.begin(9600);
   runBenchmarksSetLED();
   runBenchmarksInvertLED();
   runBenchmarksFillRect();
   runBenchmarksInvertRect();
+  runBenchmarksSetLEDs();
+  runBenchmarksGetRow();
+  runBenchmarksGetColumn();
+  runBenchmarksDilate();
+  runBenchmarksFloodFill();
+  runBenchmarksCopyRegion();
+  runBenchmarksCurrentLimit();
+  runBenchmarksNumberDisplay();
 }
 
 void loop() {}
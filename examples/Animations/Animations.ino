@@ -0,0 +1,98 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+
+/*
+ *  Runs two animations at the same time without blocking: a dot that bounces
+ *  between the left and right edges, and a square in the corner that blinks
+ *  on its own schedule.
+ */
+#include "Arduino_LED_Matrix.h"
+#include <LED_Matrix_Graphics.h>
+#include <LMG_Animation.h>
+#include <stdint.h>
+
+/// Moves a dot back and forth along row 3, one column every 4 updates.
+class BouncingDot : public LMG::Animation {
+  int8_t col{0};
+  int8_t direction{1};
+
+  LMG::Frame drawDot() {
+    LMG::Frame dot{};
+    dot.setLED(3, col, HIGH);
+    return dot;
+  }
+
+  void step() override {
+    LMG_ANIMATION_BEGIN();
+    while (true) {
+      LMG_YIELD(drawDot());
+      LMG_AWAIT_FRAMES(4);
+      if (col + direction < 0 || col + direction >= LMG::LED_MATRIX_WIDTH) {
+        direction = -direction;
+      }
+      col += direction;
+    }
+    LMG_ANIMATION_END();
+  }
+};
+
+/// Blinks a 2x2 square in the bottom right corner five times.
+class BlinkingSquare : public LMG::Animation {
+  uint8_t blinks{0};
+
+  LMG::Frame drawSquare() {
+    LMG::Frame square{};
+    square.fillRect(LMG::Rect(6, 7, 10, 11), HIGH);
+    return square;
+  }
+
+  void step() override {
+    LMG_ANIMATION_BEGIN();
+    for (blinks = 0; blinks < 5; blinks++) {
+      LMG_YIELD(drawSquare());
+      LMG_AWAIT_MS(500);
+      LMG_YIELD(LMG::Frame{});
+      LMG_AWAIT_MS(500);
+    }
+    LMG_ANIMATION_END();
+  }
+};
+
+ArduinoLEDMatrix matrix{};
+LMG::Scheduler<2> scheduler{};
+BouncingDot dot{};
+BlinkingSquare square{};
+
+void setup() {
+  matrix.begin();
+  scheduler.add(dot);
+  scheduler.add(square);
+}
+
+void loop() {
+  matrix.loadFrame(scheduler.update(millis()).getData());
+
+  // Other work, such as reading buttons, can be done here without waiting
+  // for the animations.
+  delay(20);
+}
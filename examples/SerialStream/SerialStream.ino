@@ -0,0 +1,56 @@
+/*!
+ *  Copyright 2025 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/* This program displays frames streamed from a computer over USB serial, using
+ * the protocol from LMG_Stream.h. The frames can be sent with the
+ * stream_sender tool in extras/host, for example:
+ *
+ * stream_sender /dev/ttyACM0 115200 animation.bin 30
+ */
+
+#include "Arduino_LED_Matrix.h"
+#include <LED_Matrix_Graphics.h>
+#include <LMG_Stream.h>
+
+ArduinoLEDMatrix matrix{};
+
+// The frame that the decoder writes received packets into.
+LMG::Frame frame{};
+LMG::StreamDecoder decoder{frame};
+
+void setup() {
+  Serial.begin(115200);
+  matrix.begin();
+}
+
+void loop() {
+  bool updated = false;
+  while (Serial.available() > 0) {
+    if (decoder.feed(Serial.read())) {
+      updated = true;
+    }
+  }
+  // Only the newest frame is shown if several arrived at once.
+  if (updated) {
+    matrix.loadFrame(frame.getData());
+  }
+}
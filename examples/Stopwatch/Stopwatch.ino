@@ -26,40 +26,31 @@
  */
 #include "Arduino_LED_Matrix.h"
 #include <LED_Matrix_Graphics.h>
+#include <LMG_NumberDisplay.h>
 #include <stdint.h>
 
 ArduinoLEDMatrix matrix{};
 LMG::Frame frame{};
 uint32_t start{0};
 
+// Tens of seconds, seconds and hundreds of milliseconds.
+const int8_t DIGIT_COLUMNS[] = {0, 4, 9};
+LMG::NumberDisplay display{1, DIGIT_COLUMNS, 3};
+
 void setup() {
   matrix.begin();
   start = millis();
 
-  // Draw the decimal point
-  frame.setLED(5, 7, HIGH);
+  // The last digit is a fraction of a second. The first digit is not
+  // displayed while the time is less than 10 seconds.
+  display.setDecimalPoint(LMG::Rect(5, 5, 7, 7), 1);
 }
 
 void loop() {
-  using LMG::Rect;
-
-  // Offset at which the digit sprites are stored
-  constexpr size_t DIGITS_OFFSET = 29;
   const uint32_t diff = millis() - start;
-  const size_t tens_of_seconds = (diff / 10000) % 10;
-  const size_t seconds = (diff / 1000) % 10;
-  const size_t hundreds_of_ms = (diff / 100) % 10;
 
-  if (tens_of_seconds == 0) {
-    // Don't display the first digit if the time is less than 10 seconds.
-    frame.fillRect(Rect(1, 5, 0, 2), LOW);
-  } else {
-    frame.drawSprite(LMG::DEFAULT_FONT_3x5[tens_of_seconds + DIGITS_OFFSET],
-                     Rect(1, 5, 0, 2));
-  }
-  frame.drawSprite(LMG::DEFAULT_FONT_3x5[seconds + DIGITS_OFFSET],
-                   Rect(1, 5, 4, 6));
-  frame.drawSprite(LMG::DEFAULT_FONT_3x5[hundreds_of_ms + DIGITS_OFFSET],
-                   Rect(1, 5, 9, 11));
+  // Only the digits that changed since the last call are redrawn.
+  display.setValue((diff / 100) % 1000);
+  display.draw(frame);
   matrix.loadFrame(frame.getData());
 }
@@ -19,13 +19,35 @@
  *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
  *  IN THE SOFTWARE.
  */
+
+/// Uncomment to measure the time from reading a button to loading the first
+/// frame that shows its effect. The statistics are printed over serial every
+/// few seconds.
+// #define LMG_TRACE_LATENCY
+
 #include "Arduino_LED_Matrix.h"
 #include "Tetris.h" // Contains the game code
 #include <LED_Matrix_Graphics.h>
+#include <LMG_NumberDisplay.h>
+#ifdef LMG_TRACE_LATENCY
+#include <LMG_Trace.h>
+#endif
 
 ArduinoLEDMatrix matrix{};
 LMG::Frame placed{};
 GameState game{};
+
+/// The screen that shows the score once the game is over.
+LMG::Frame score_screen{};
+const int8_t SCORE_COLUMNS[] = {1, 5, 9};
+LMG::NumberDisplay score_display{1, SCORE_COLUMNS, 3};
+
+#ifdef LMG_TRACE_LATENCY
+LMG::LatencyTracer<4, 64> tracer{};
+constexpr unsigned long LATENCY_REPORT_INTERVAL{5000};
+unsigned long last_latency_report{0};
+#endif
+
 bool rotate_button_pushed{false};
 bool shift_left_button_pushed{false};
 bool shift_right_button_pushed{false};
@@ -38,6 +60,9 @@ constexpr pin_size_t SHIFT_LEFT_BUTTON{4};
 constexpr pin_size_t SHIFT_RIGHT_BUTTON{5};
 
 void setup() {
+#ifdef LMG_TRACE_LATENCY
+  Serial.begin(115200);
+#endif
   matrix.begin();
   pinMode(DROP_PIECE_BUTTON, INPUT);
   pinMode(ROTATE_PIECE_BUTTON, INPUT);
@@ -48,23 +73,55 @@ void setup() {
   srand(analogRead(A2));
   /// Reset the game with the new RNG seed
   game.reset();
+  /// The score is shown with all three digits, including leading zeros
+  score_display.setLeadingZeros(true);
+}
+
+/// Applies a button press to the game
+template <typename Action> void handleInput(Action action) {
+#ifdef LMG_TRACE_LATENCY
+  // A press that leaves the active piece where it was never shows up on the
+  // matrix, so it is not traced. Any other press is shown by the next frame
+  // that is loaded, which is drawn after the game state was updated.
+  const int8_t id = tracer.input(micros());
+  const LMG::Frame before = game.drawActive();
+  action();
+  if (game.drawActive() == before) {
+    tracer.cancel(id);
+  } else {
+    tracer.applied(id);
+  }
+#else
+  action();
+#endif
+}
+
+#ifdef LMG_TRACE_LATENCY
+/// Prints the input latencies in microseconds every few seconds
+void reportLatency() {
+  const LMG::LatencyStats stats = tracer.stats();
+  if (millis() - last_latency_report < LATENCY_REPORT_INTERVAL ||
+      stats.count == 0) {
+    return;
+  }
+  last_latency_report = millis();
+  Serial.print("latency us: n=");
+  Serial.print(stats.count);
+  Serial.print(" min=");
+  Serial.print(stats.min);
+  Serial.print(" p50=");
+  Serial.print(stats.p50);
+  Serial.print(" p99=");
+  Serial.print(stats.p99);
+  Serial.print(" max=");
+  Serial.println(stats.max);
 }
+#endif
 
 /// Draws the current game score to the screen
 void drawScore() {
-  using LMG::Frame, LMG::Rect, LMG::DEFAULT_FONT_3x5;
-  Frame score_screen{};
-  const uint32_t score = game.getScore();
-  constexpr size_t DIGITS_OFFSET{29};
-  const size_t ones = score % 10;
-  score_screen.drawSprite(DEFAULT_FONT_3x5[DIGITS_OFFSET + ones],
-                          Rect(1, 5, 9, 11));
-  const size_t tens = (score / 10) % 10;
-  score_screen.drawSprite(DEFAULT_FONT_3x5[DIGITS_OFFSET + tens],
-                          Rect(1, 5, 5, 7));
-  const size_t hundreds = (score / 100) % 10;
-  score_screen.drawSprite(DEFAULT_FONT_3x5[DIGITS_OFFSET + hundreds],
-                          Rect(1, 5, 1, 3));
+  score_display.setValue(game.getScore());
+  score_display.draw(score_screen);
   matrix.loadFrame(score_screen.getData());
 }
 
@@ -79,7 +136,7 @@ void loop() {
   // Controls for piece rotation
   if (digitalRead(ROTATE_PIECE_BUTTON) == HIGH) {
     if (!rotate_button_pushed) {
-      game.rotatePiece();
+      handleInput([] { game.rotatePiece(); });
       rotate_button_pushed = true;
     }
   } else {
@@ -89,7 +146,7 @@ void loop() {
   // Controls for shifting pieces
   if (digitalRead(SHIFT_LEFT_BUTTON) == HIGH) {
     if (!shift_left_button_pushed) {
-      game.shiftPieceLeft();
+      handleInput([] { game.shiftPieceLeft(); });
       shift_left_button_pushed = true;
     }
   } else {
@@ -98,7 +155,7 @@ void loop() {
 
   if (digitalRead(SHIFT_RIGHT_BUTTON) == HIGH) {
     if (!shift_right_button_pushed) {
-      game.shiftPieceRight();
+      handleInput([] { game.shiftPieceRight(); });
       shift_right_button_pushed = true;
     }
   } else {
@@ -107,7 +164,7 @@ void loop() {
 
   // Controls for dropping pieces
   if (digitalRead(DROP_PIECE_BUTTON) == HIGH) {
-    game.tryDescend();
+    handleInput([] { game.tryDescend(); });
   }
 
   // Update the game state
@@ -118,4 +175,8 @@ void loop() {
 
   // Combine the placed pieces with the active piece and update the screen
   matrix.loadFrame((placed + game.drawActive()).getData());
+#ifdef LMG_TRACE_LATENCY
+  tracer.presented(micros());
+  reportLatency();
+#endif
 }
@@ -28,17 +28,22 @@
 
 #include "Arduino_LED_Matrix.h"
 #include <LED_Matrix_Graphics.h>
+#include <LMG_FrameCache.h>
 #include <cstdint>
 
 ArduinoLEDMatrix matrix{};
 
+// Remembers the frames for the most recently displayed readings.
+LMG::FrameCache<int16_t, 16> cache{};
+
 void setup() {
   matrix.begin();
   pinMode(A0, INPUT);
   pinMode(A1, INPUT);
 }
 
-void loop() {
+/// Draws a reading between -1023 and 1023 as a fraction of 1023.
+LMG::Frame drawReading(int16_t rel_voltage) {
   using LMG::Rect;
 
   // Index at which the sprites for digits start in the default font.
@@ -55,7 +60,6 @@ void loop() {
   // Area where the negative sign is drawn.
   const Rect NEGATIVE_SIGN{6, 6, 8, 10};
 
-  int16_t rel_voltage = analogRead(A0) - analogRead(A1);
   const bool negative = (rel_voltage < 0);
 
   if (negative) {
@@ -89,7 +93,13 @@ void loop() {
     frame.fillRect(NEGATIVE_SIGN, HIGH);
   }
 
-  // Updates the matrix.
-  matrix.loadFrame(frame.getData());
+  return frame;
+}
+
+void loop() {
+  const int16_t rel_voltage = analogRead(A0) - analogRead(A1);
+
+  // Updates the matrix. Readings that were shown recently are not redrawn.
+  matrix.loadFrame(cache.get(rel_voltage, drawReading).getData());
   delay(200);
 }
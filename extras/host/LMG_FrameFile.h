@@ -0,0 +1,72 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Writes a frame in the frame file format.
+/**
+ * @param out   The stream to write to. Should be opened in binary mode.
+ * @param frame The frame to write.
+ *
+ * A frame file is a plain sequence of frames. Each frame takes 12 bytes: the
+ * three words returned by `Frame::getData`, each stored most significant byte
+ * first.
+ */
+inline void writeFrame(std::ostream &out, const Frame &frame) {
+  const uint32_t *raw = frame.getData();
+  char bytes[12];
+  for (size_t i = 0; i < 12; i++) {
+    bytes[i] = static_cast<char>(raw[i / 4] >> (24 - 8 * (i % 4)));
+  }
+  out.write(bytes, sizeof(bytes));
+}
+
+/// Reads a frame in the frame file format.
+/**
+ * @param in    The stream to read from. Should be opened in binary mode.
+ * @param frame Receives the frame that was read.
+ * @returns True, if a whole frame was read; false, otherwise.
+ */
+inline bool readFrame(std::istream &in, Frame &frame) {
+  unsigned char bytes[12];
+  if (!in.read(reinterpret_cast<char *>(bytes), sizeof(bytes))) {
+    return false;
+  }
+  uint32_t raw[3] = {0, 0, 0};
+  for (size_t i = 0; i < 12; i++) {
+    raw[i / 4] |= static_cast<uint32_t>(bytes[i]) << (24 - 8 * (i % 4));
+  }
+  frame = Frame(raw);
+  return true;
+}
+
+} // namespace LMG
@@ -0,0 +1,268 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Straightforward per-pixel versions of the drawing operations of Frame and
+ *  Rect. They are far too slow for the Arduino, but simple enough to be
+ *  obviously correct, which makes them an oracle for the word-level kernels
+ *  in src/. See fuzz_frame.cpp.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Stores the state of the LED matrix as one bool per LED.
+class ReferenceFrame {
+  bool leds[LED_MATRIX_HEIGHT][LED_MATRIX_WIDTH]{};
+
+  static bool inBounds(const int row, const int col) {
+    return row >= 0 && row < LED_MATRIX_HEIGHT && col >= 0 &&
+           col < LED_MATRIX_WIDTH;
+  }
+
+  /// Calls f(row, col) for every LED of the matrix.
+  template <typename F> static void forEachLED(F f) {
+    for (int row = 0; row < LED_MATRIX_HEIGHT; row++) {
+      for (int col = 0; col < LED_MATRIX_WIDTH; col++) {
+        f(row, col);
+      }
+    }
+  }
+
+  /// Returns the number of lit neighbours of an LED, including diagonal ones.
+  int neighbours(const int row, const int col, const bool wrap) const {
+    int count = 0;
+    for (int d_row = -1; d_row <= 1; d_row++) {
+      for (int d_col = -1; d_col <= 1; d_col++) {
+        if (d_row == 0 && d_col == 0) {
+          continue;
+        }
+        int r = row + d_row;
+        int c = col + d_col;
+        if (wrap) {
+          r = (r + LED_MATRIX_HEIGHT) % LED_MATRIX_HEIGHT;
+          c = (c + LED_MATRIX_WIDTH) % LED_MATRIX_WIDTH;
+        }
+        count += getLED(r, c);
+      }
+    }
+    return count;
+  }
+
+public:
+  /// Constructs a frame with all lights off.
+  ReferenceFrame() {}
+
+  /// Constructs a frame from raw frame data, decoding every LED on its own.
+  explicit ReferenceFrame(const std::array<uint32_t, 3> &words) {
+    forEachLED([&](int row, int col) {
+      const int pos = row * LED_MATRIX_WIDTH + col;
+      leds[row][col] = (words[pos / 32] >> (31 - pos % 32)) & 1;
+    });
+  }
+
+  /// Returns the frame data in the layout that is documented for
+  /// `Frame::getData`: LED (row, col) is bit 31 - (row * 12 + col) % 32 of
+  /// word (row * 12 + col) / 32.
+  std::array<uint32_t, 3> pack() const {
+    std::array<uint32_t, 3> words{0, 0, 0};
+    forEachLED([&](int row, int col) {
+      const int pos = row * LED_MATRIX_WIDTH + col;
+      if (leds[row][col]) {
+        words[pos / 32] |= uint32_t{1} << (31 - pos % 32);
+      }
+    });
+    return words;
+  }
+
+  bool getLED(const int row, const int col) const {
+    return inBounds(row, col) && leds[row][col];
+  }
+
+  void setLED(const int row, const int col, const bool bit) {
+    if (inBounds(row, col)) {
+      leds[row][col] = bit;
+    }
+  }
+
+  void invertLED(const int row, const int col) {
+    if (inBounds(row, col)) {
+      leds[row][col] = !leds[row][col];
+    }
+  }
+
+  uint8_t count() const {
+    uint8_t lit = 0;
+    forEachLED([&](int row, int col) { lit += leds[row][col]; });
+    return lit;
+  }
+
+  uint16_t getRow(const int row) const {
+    uint16_t bits = 0;
+    for (int col = 0; col < LED_MATRIX_WIDTH; col++) {
+      bits = (bits << 1) | getLED(row, col);
+    }
+    return bits;
+  }
+
+  void setRow(const int row, const uint16_t bits) {
+    for (int col = 0; col < LED_MATRIX_WIDTH; col++) {
+      setLED(row, col, bits & (0x800 >> col));
+    }
+  }
+
+  uint8_t getColumn(const int col) const {
+    uint8_t bits = 0;
+    for (int row = 0; row < LED_MATRIX_HEIGHT; row++) {
+      bits = (bits << 1) | getLED(row, col);
+    }
+    return bits;
+  }
+
+  void setColumn(const int col, const uint8_t bits) {
+    for (int row = 0; row < LED_MATRIX_HEIGHT; row++) {
+      setLED(row, col, bits & (0x80 >> row));
+    }
+  }
+
+  void plot(const int row, const int col, const PlotMode mode) {
+    switch (mode) {
+    case PlotMode::Set:
+      setLED(row, col, true);
+      break;
+    case PlotMode::Clear:
+      setLED(row, col, false);
+      break;
+    case PlotMode::Toggle:
+      invertLED(row, col);
+      break;
+    }
+  }
+
+  /// The rectangle is given by its inclusive bounds, which may lie outside of
+  /// the matrix.
+  void fillRect(const int low_row, const int high_row, const int low_col,
+                const int high_col, const bool bit) {
+    for (int row = low_row; row <= high_row; row++) {
+      for (int col = low_col; col <= high_col; col++) {
+        setLED(row, col, bit);
+      }
+    }
+  }
+
+  void invertRect(const int low_row, const int high_row, const int low_col,
+                  const int high_col) {
+    for (int row = low_row; row <= high_row; row++) {
+      for (int col = low_col; col <= high_col; col++) {
+        invertLED(row, col);
+      }
+    }
+  }
+
+  /// Draws the rows from `low_row` to `high_row` and the columns from
+  /// `low_col` to `high_col` of a sprite sheet, so that (low_row, low_col)
+  /// ends up at (row, col).
+  void drawSprite(const bool *sheet, const size_t stride, const int low_row,
+                  const int high_row, const int low_col, const int high_col,
+                  const int row, const int col) {
+    for (int r = low_row; r <= high_row; r++) {
+      for (int c = low_col; c <= high_col; c++) {
+        setLED(row + r - low_row, col + c - low_col, sheet[r * stride + c]);
+      }
+    }
+  }
+
+  void shiftRows(const int shift) {
+    ReferenceFrame old = *this;
+    forEachLED([&](int row, int col) {
+      leds[row][col] = old.getLED(row - shift, col);
+    });
+  }
+
+  void shiftColumns(const int shift) {
+    ReferenceFrame old = *this;
+    forEachLED([&](int row, int col) {
+      leds[row][col] = old.getLED(row, col - shift);
+    });
+  }
+
+  void lifeStep(const LifeRule &rule, const bool wrap) {
+    ReferenceFrame old = *this;
+    forEachLED([&](int row, int col) {
+      const uint16_t bit = 1 << old.neighbours(row, col, wrap);
+      leds[row][col] = (old.leds[row][col] ? rule.survival : rule.birth) & bit;
+    });
+  }
+
+  void dilate() {
+    ReferenceFrame old = *this;
+    forEachLED([&](int row, int col) {
+      leds[row][col] = old.leds[row][col] || old.neighbours(row, col, false);
+    });
+  }
+
+  void erode() {
+    ReferenceFrame old = *this;
+    forEachLED([&](int row, int col) {
+      leds[row][col] =
+          old.leds[row][col] && old.neighbours(row, col, false) == 8;
+    });
+  }
+
+  void outline() {
+    ReferenceFrame old = *this;
+    forEachLED([&](int row, int col) {
+      leds[row][col] = !old.leds[row][col] && old.neighbours(row, col, false);
+    });
+  }
+
+  void floodFill(const int row, const int col) {
+    if (!inBounds(row, col) || leds[row][col]) {
+      return;
+    }
+    leds[row][col] = true;
+    floodFill(row - 1, col);
+    floodFill(row + 1, col);
+    floodFill(row, col - 1);
+    floodFill(row, col + 1);
+  }
+
+  /// Applies an operation to every LED where `area` is lit.
+  template <typename F> void forEachIn(const ReferenceFrame &area, F f) {
+    forEachLED([&](int row, int col) {
+      if (area.leds[row][col]) {
+        f(row, col);
+      }
+    });
+  }
+};
+
+} // namespace LMG
@@ -0,0 +1,200 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Host-side helpers for generating animations on a PC. This file uses
+ *  threads and standard streams, so it is not meant to be compiled for the
+ *  Arduino; it lives outside of src/ for that reason. Link it against
+ *  src/LED_Matrix_Graphics.cpp, for example:
+ *
+ *  g++ -std=c++17 -O2 -pthread -Isrc -Iextras/host my_tool.cpp \
+ *      src/LED_Matrix_Graphics.cpp
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_FrameFile.h"
+
+namespace LMG {
+
+namespace detail {
+
+/// A range of frame indices owned by one worker, packed into a single atomic
+/// so that the owner and the thieves can update it with one CAS. The first
+/// index is stored in the high half and the end index in the low half.
+class WorkRange {
+  std::atomic<uint64_t> packed{0};
+
+  static uint64_t pack(const uint32_t begin, const uint32_t end) {
+    return (static_cast<uint64_t>(begin) << 32) | end;
+  }
+
+public:
+  void reset(const uint32_t begin, const uint32_t end) {
+    packed.store(pack(begin, end), std::memory_order_relaxed);
+  }
+
+  /// Takes the first index of the range. Used by the owner.
+  bool take(uint32_t &index) {
+    uint64_t current = packed.load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t begin = current >> 32;
+      const uint32_t end = static_cast<uint32_t>(current);
+      if (begin >= end) {
+        return false;
+      }
+      if (packed.compare_exchange_weak(current, pack(begin + 1, end),
+                                       std::memory_order_acq_rel)) {
+        index = begin;
+        return true;
+      }
+    }
+  }
+
+  /// Takes the upper half of the range. Used by the other workers.
+  bool steal(uint32_t &begin, uint32_t &end) {
+    uint64_t current = packed.load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t own_begin = current >> 32;
+      const uint32_t own_end = static_cast<uint32_t>(current);
+      if (own_begin >= own_end) {
+        return false;
+      }
+      const uint32_t middle = own_begin + (own_end - own_begin) / 2;
+      if (packed.compare_exchange_weak(current, pack(own_begin, middle),
+                                       std::memory_order_acq_rel)) {
+        begin = middle;
+        end = own_end;
+        return true;
+      }
+    }
+  }
+};
+
+} // namespace detail
+
+/// Generates the frames of an animation in parallel.
+/**
+ * @param generate A function that takes a frame index (`uint32_t`) and returns
+ *                 the `Frame` for it. It is called from several threads at
+ *                 once, so it must not modify shared state.
+ * @param count    Number of frames to generate.
+ * @param threads  Number of worker threads. Zero uses every available core;
+ *                 one generates the frames on the calling thread.
+ * @returns The generated frames, ordered by index.
+ *
+ * Every worker starts with an equal share of the indices. A worker that runs
+ * out of work steals half of the remaining indices of another worker, so
+ * frames that take longer to generate do not leave the other cores idle.
+ * The result does not depend on the number of threads.
+ */
+template <typename Generate>
+std::vector<Frame> renderFrames(Generate generate, const uint32_t count,
+                                unsigned threads = 0) {
+  std::vector<Frame> frames(count);
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min<unsigned>(threads, std::max<uint32_t>(count, 1));
+
+  if (threads == 1) {
+    for (uint32_t index = 0; index < count; index++) {
+      frames[index] = generate(index);
+    }
+    return frames;
+  }
+
+  std::unique_ptr<detail::WorkRange[]> ranges(new detail::WorkRange[threads]);
+  for (unsigned worker = 0; worker < threads; worker++) {
+    const uint64_t begin = static_cast<uint64_t>(count) * worker / threads;
+    const uint64_t end = static_cast<uint64_t>(count) * (worker + 1) / threads;
+    ranges[worker].reset(begin, end);
+  }
+
+  const auto work = [&](const unsigned worker) {
+    while (true) {
+      uint32_t index = 0;
+      while (ranges[worker].take(index)) {
+        frames[index] = generate(index);
+      }
+
+      // Looks for another worker that still has indices left.
+      bool stolen = false;
+      for (unsigned offset = 1; offset < threads && !stolen; offset++) {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        if (ranges[(worker + offset) % threads].steal(begin, end)) {
+          ranges[worker].reset(begin, end);
+          stolen = true;
+        }
+      }
+      if (!stolen) {
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned worker = 1; worker < threads; worker++) {
+    pool.emplace_back(work, worker);
+  }
+  work(0);
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  return frames;
+}
+
+/// Generates the frames of an animation in parallel and writes them to a
+/// frame file.
+/**
+ * @param out      The stream to write to. Should be opened in binary mode.
+ * @param generate A function that takes a frame index and returns the
+ *                 `Frame` for it. See `renderFrames`.
+ * @param count    Number of frames to generate.
+ * @param threads  Number of worker threads. Zero uses every available core.
+ * @returns True, if all of the frames were written successfully.
+ *
+ * The frames are written in index order, so the file is byte-identical to
+ * the one produced with a single thread.
+ */
+template <typename Generate>
+bool renderAnimation(std::ostream &out, Generate generate,
+                     const uint32_t count, const unsigned threads = 0) {
+  for (const Frame &frame : renderFrames(generate, count, threads)) {
+    writeFrame(out, frame);
+  }
+  return static_cast<bool>(out);
+}
+
+} // namespace LMG
@@ -0,0 +1,105 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Opens serial ports on Linux for the host tools. Pseudo-terminals work as
+ *  well, which makes it possible to test the tools against each other, e.g.
+ *  with `socat -d -d pty,raw,echo=0 pty,raw,echo=0`.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace LMG {
+
+/// Converts a baud rate into the matching termios constant.
+/**
+ * @returns The termios constant, or B0 if the rate is not supported.
+ */
+inline speed_t baudConstant(const uint32_t baud) {
+  switch (baud) {
+  case 9600:
+    return B9600;
+  case 19200:
+    return B19200;
+  case 38400:
+    return B38400;
+  case 57600:
+    return B57600;
+  case 115200:
+    return B115200;
+  case 230400:
+    return B230400;
+  case 460800:
+    return B460800;
+  case 921600:
+    return B921600;
+  case 1000000:
+    return B1000000;
+  case 2000000:
+    return B2000000;
+  default:
+    return B0;
+  }
+}
+
+/// Opens a serial port in raw 8N1 mode.
+/**
+ * @param path Path of the serial device, such as /dev/ttyACM0.
+ * @param baud The baud rate.
+ * @returns A file descriptor, or -1 if the port could not be opened or the
+ *          baud rate is not supported.
+ */
+inline int openSerialPort(const char *path, const uint32_t baud) {
+  const speed_t speed = baudConstant(baud);
+  if (speed == B0) {
+    return -1;
+  }
+  const int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) {
+    return -1;
+  }
+  termios settings{};
+  if (tcgetattr(fd, &settings) != 0) {
+    close(fd);
+    return -1;
+  }
+  cfmakeraw(&settings);
+  cfsetispeed(&settings, speed);
+  cfsetospeed(&settings, speed);
+  settings.c_cflag |= CLOCAL | CREAD;
+  settings.c_cc[VMIN] = 1;
+  settings.c_cc[VTIME] = 0;
+  if (tcsetattr(fd, TCSANOW, &settings) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+} // namespace LMG
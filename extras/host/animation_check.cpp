@@ -0,0 +1,165 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Checks the sequencing of animations from src/LMG_Animation.h against a
+ *  simulated clock: when frames are yielded, how long LMG_AWAIT_MS and
+ *  LMG_AWAIT_FRAMES wait (including across the wraparound of millis()), and
+ *  how several animations are combined by a Scheduler.
+ *
+ *  Usage: animation_check
+ *
+ *  Build: g++ -std=c++17 -O2 -Wall -Wextra -Isrc \
+ *             extras/host/animation_check.cpp src/LED_Matrix_Graphics.cpp \
+ *             -o animation_check
+ */
+
+#include <cstdint>
+#include <iostream>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_Animation.h"
+
+namespace {
+
+int failures = 0;
+
+void check(const bool condition, const char *description) {
+  if (!condition) {
+    std::cerr << "FAILED: " << description << "\n";
+    failures++;
+  }
+}
+
+/// Returns a frame with only the given LED lit.
+LMG::Frame dot(const int8_t row, const int8_t col) {
+  LMG::Frame frame{};
+  frame.setLED(row, col, true);
+  return frame;
+}
+
+/// Lights (0,0) for 100 ms, then (0,1) for 3 updates, then finishes.
+class Timed : public LMG::Animation {
+  void step() override {
+    LMG_ANIMATION_BEGIN();
+    LMG_YIELD(dot(0, 0));
+    LMG_AWAIT_MS(100);
+    LMG_YIELD(dot(0, 1));
+    LMG_AWAIT_FRAMES(3);
+    LMG_YIELD(LMG::Frame{});
+    LMG_ANIMATION_END();
+  }
+};
+
+/// Moves a dot along row 1, one column per update, in a loop that is driven
+/// by a member.
+class Walker : public LMG::Animation {
+  int8_t col{0};
+
+  void step() override {
+    LMG_ANIMATION_BEGIN();
+    for (col = 0; col < 4; col++) {
+      LMG_YIELD(dot(1, col));
+    }
+    LMG_ANIMATION_END();
+  }
+};
+
+/// Runs a Timed animation from `start` in steps of 10 ms and checks when
+/// every frame appears.
+void checkTimed(const uint32_t start) {
+  Timed timed;
+  LMG::Scheduler<1> scheduler;
+  scheduler.add(timed);
+
+  uint32_t now = start;
+  check(scheduler.update(now) == dot(0, 0), "first frame");
+
+  // The wait starts on the update after the frame was shown, at 10 ms, and
+  // the second frame appears once 100 ms have passed since then.
+  uint32_t updates = 0;
+  while (scheduler.update(now += 10) == dot(0, 0) && updates < 100) {
+    updates++;
+  }
+  check(updates == 10, "LMG_AWAIT_MS waits for 100 ms");
+  check(timed.getFrame() == dot(0, 1), "second frame");
+  check(now - start == 110, "time of the second frame");
+
+  // LMG_AWAIT_FRAMES(3) skips three updates, starting with the one after the
+  // frame was shown.
+  for (int i = 0; i < 3; i++) {
+    check(scheduler.update(now += 10) == dot(0, 1), "LMG_AWAIT_FRAMES waits");
+  }
+  check(!scheduler.update(now += 10), "LMG_AWAIT_FRAMES resumes");
+  check(!scheduler.isFinished(), "not finished before LMG_ANIMATION_END");
+  scheduler.update(now += 10);
+  check(scheduler.isFinished(), "finished after LMG_ANIMATION_END");
+}
+
+void checkScheduler() {
+  Timed timed;
+  Walker walker;
+  LMG::Scheduler<2> scheduler;
+  check(scheduler.add(timed), "add the first animation");
+  check(scheduler.add(walker), "add the second animation");
+  check(!scheduler.add(walker), "reject an animation when full");
+
+  // Both animations advance on every update and their frames are combined.
+  uint32_t now = 0;
+  for (int8_t col = 0; col < 4; col++) {
+    check(scheduler.update(now++) == dot(0, 0) + dot(1, col),
+          "combined frames");
+  }
+
+  // The walker keeps its last frame once it has finished.
+  scheduler.update(now++);
+  check(walker.isFinished(), "walker finished");
+  check(scheduler.update(now++) == dot(0, 0) + dot(1, 3),
+        "finished animations keep their frame");
+
+  // Restarting starts the loop over.
+  walker.restart();
+  check(scheduler.update(now++) == dot(0, 0) + dot(1, 0), "restart");
+
+  scheduler.remove(timed);
+  check(scheduler.update(now++) == dot(1, 1), "remove an animation");
+}
+
+} // namespace
+
+int main() {
+  checkTimed(0);
+
+  // millis() wraps around after about 49 days.
+  checkTimed(UINT32_MAX - 35);
+
+  checkScheduler();
+
+  if (failures > 0) {
+    std::cerr << failures << " checks failed\n";
+    return 1;
+  }
+  std::cerr << "all checks passed\n";
+  return 0;
+}
@@ -0,0 +1,547 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Differential fuzzer for the drawing operations of Frame, Rect and Region.
+ *
+ *  Every operation is applied both to a Frame and to the per-pixel
+ *  ReferenceFrame from LMG_Reference.h, and the 96 bits of the two are
+ *  compared after every step. Coordinates are drawn from a range that reaches
+ *  well outside the matrix, so that clipped, inverted and degenerate
+ *  rectangles are exercised as much as the ordinary ones.
+ *
+ *  Usage: fuzz_frame [programs] [seed]
+ *
+ *  Runs the given number of random programs (default 100000), each starting
+ *  from a random frame. Program i uses seed + i, so the first mismatch is
+ *  printed together with a command that replays just that program.
+ *
+ *  Build: g++ -std=c++17 -O2 -Isrc -Iextras/host extras/host/fuzz_frame.cpp \
+ *             src/LED_Matrix_Graphics.cpp -o fuzz_frame
+ *
+ *  The same file is a libFuzzer target when LMG_LIBFUZZER is defined, in
+ *  which case the input bytes drive the operations:
+ *
+ *  clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined \
+ *          -DLMG_LIBFUZZER -Isrc -Iextras/host extras/host/fuzz_frame.cpp \
+ *          src/LED_Matrix_Graphics.cpp -o fuzz_frame
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_Reference.h"
+
+namespace {
+
+using LMG::Frame;
+using LMG::PlotMode;
+using LMG::Rect;
+using LMG::ReferenceFrame;
+using LMG::Region;
+
+/// Supplies the bytes that choose the operations and their arguments, either
+/// from a seeded generator or from a fuzzer input.
+class ByteSource {
+  std::mt19937 rng;
+  const uint8_t *data{nullptr};
+  size_t size{0};
+  bool from_data{false};
+
+public:
+  explicit ByteSource(const uint32_t seed) : rng(seed) {}
+
+  ByteSource(const uint8_t *data, const size_t size)
+      : data(data), size(size), from_data(true) {}
+
+  /// Returns true once a fuzzer input is used up.
+  bool exhausted() const { return from_data && size == 0; }
+
+  uint8_t byte() {
+    if (!from_data) {
+      return static_cast<uint8_t>(rng());
+    }
+    if (size == 0) {
+      return 0;
+    }
+    size--;
+    return *data++;
+  }
+
+  uint32_t word() {
+    return (static_cast<uint32_t>(byte()) << 24) |
+           (static_cast<uint32_t>(byte()) << 16) |
+           (static_cast<uint32_t>(byte()) << 8) | byte();
+  }
+
+  /// Returns a value between low and high, inclusively.
+  int range(const int low, const int high) {
+    return low + static_cast<int>(word() % (high - low + 1));
+  }
+
+  /// Returns a row or column. Most are close to the matrix, but some are far
+  /// enough away to catch overflows in the clipping code.
+  int8_t coordinate() {
+    return byte() < 224 ? range(-4, 15) : range(-40, 50);
+  }
+
+  /// Returns frame data that is sparse, dense or evenly mixed.
+  std::array<uint32_t, 3> frameData() {
+    std::array<uint32_t, 3> words{};
+    const uint8_t density = byte() % 3;
+    for (uint32_t &w : words) {
+      w = word();
+      if (density == 0) {
+        w &= word();
+      } else if (density == 1) {
+        w |= word();
+      }
+    }
+    return words;
+  }
+
+  Rect rect() {
+    return Rect(coordinate(), coordinate(), coordinate(), coordinate());
+  }
+
+  PlotMode plotMode() {
+    switch (byte() % 3) {
+    case 0:
+      return PlotMode::Set;
+    case 1:
+      return PlotMode::Clear;
+    default:
+      return PlotMode::Toggle;
+    }
+  }
+};
+
+/// Bounds of a rectangle as plain integers, for the reference model.
+struct Bounds {
+  int low_row;
+  int high_row;
+  int low_col;
+  int high_col;
+};
+
+Bounds boundsOf(Rect rect) {
+  return {rect.getLowRow(), rect.getHighRow(), rect.getLowCol(),
+          rect.getHighCol()};
+}
+
+/// Returns the reference version of a region: the LEDs covered by the
+/// rectangles, found one LED at a time.
+ReferenceFrame referenceRegion(const Bounds *rects, const size_t n) {
+  ReferenceFrame area{};
+  for (size_t i = 0; i < n; i++) {
+    area.fillRect(rects[i].low_row, rects[i].high_row, rects[i].low_col,
+                  rects[i].high_col, true);
+  }
+  return area;
+}
+
+/// Checks Rect::operator& against a brute force search over every point of a
+/// grid that contains both rectangles.
+bool checkIntersection(Rect a, Rect b) {
+  const Bounds x = boundsOf(a);
+  const Bounds y = boundsOf(b);
+  std::optional<Bounds> expected;
+  for (int row = -64; row <= 64; row++) {
+    for (int col = -64; col <= 64; col++) {
+      const bool in_x = row >= x.low_row && row <= x.high_row &&
+                        col >= x.low_col && col <= x.high_col;
+      const bool in_y = row >= y.low_row && row <= y.high_row &&
+                        col >= y.low_col && col <= y.high_col;
+      if (!in_x || !in_y) {
+        continue;
+      }
+      if (!expected) {
+        expected = Bounds{row, row, col, col};
+      }
+      expected->high_row = row;
+      expected->low_col = std::min(expected->low_col, col);
+      expected->high_col = std::max(expected->high_col, col);
+    }
+  }
+  const std::optional<Rect> actual = a & b;
+  if (!expected || !actual) {
+    return !expected == !actual;
+  }
+  const Bounds result = boundsOf(*actual);
+  return result.low_row == expected->low_row &&
+         result.high_row == expected->high_row &&
+         result.low_col == expected->low_col &&
+         result.high_col == expected->high_col;
+}
+
+/// Compares every way of reading a frame with the reference.
+bool matches(const Frame &frame, const ReferenceFrame &reference) {
+  const std::array<uint32_t, 3> expected = reference.pack();
+  const uint32_t *actual = frame.getData();
+  for (size_t i = 0; i < 3; i++) {
+    if (actual[i] != expected[i]) {
+      return false;
+    }
+  }
+  for (int8_t row = -1; row <= LMG::LED_MATRIX_HEIGHT; row++) {
+    if (frame.getRow(row) != reference.getRow(row)) {
+      return false;
+    }
+    for (int8_t col = -1; col <= LMG::LED_MATRIX_WIDTH; col++) {
+      if (frame.getLED(row, col) != reference.getLED(row, col)) {
+        return false;
+      }
+    }
+  }
+  for (int8_t col = -1; col <= LMG::LED_MATRIX_WIDTH; col++) {
+    if (frame.getColumn(col) != reference.getColumn(col)) {
+      return false;
+    }
+  }
+  return frame.count() == reference.count() &&
+         static_cast<bool>(frame) == (reference.count() > 0);
+}
+
+/// Describes the first mismatch of a program.
+struct Failure {
+  const char *operation;
+  size_t step;
+  std::array<uint32_t, 3> expected;
+  std::array<uint32_t, 3> actual;
+};
+
+/// Largest sprite that the fuzzer draws, in rows and columns.
+constexpr int MAX_SPRITE{96};
+
+/// Applies random operations to a frame and to the reference, and compares
+/// them after every step.
+/**
+ * @returns The first mismatch, or std::nullopt if there was none.
+ */
+std::optional<Failure> runProgram(ByteSource &source, const size_t steps) {
+  static bool sheet[MAX_SPRITE * MAX_SPRITE];
+
+  const std::array<uint32_t, 3> start = source.frameData();
+  Frame frame{start.data()};
+  ReferenceFrame reference{start};
+
+  for (size_t step = 0; step < steps && !source.exhausted(); step++) {
+    const char *operation = "";
+    bool ok = true;
+    switch (source.byte() % 22) {
+    case 0: {
+      operation = "setLED";
+      const int8_t row = source.coordinate();
+      const int8_t col = source.coordinate();
+      const bool bit = source.byte() & 1;
+      frame.setLED(row, col, bit);
+      reference.setLED(row, col, bit);
+      break;
+    }
+    case 1: {
+      operation = "invertLED";
+      const int8_t row = source.coordinate();
+      const int8_t col = source.coordinate();
+      frame.invertLED(row, col);
+      reference.invertLED(row, col);
+      break;
+    }
+    case 2: {
+      operation = "fillRect";
+      const Rect area = source.rect();
+      const Bounds b = boundsOf(area);
+      const bool bit = source.byte() & 1;
+      frame.fillRect(area, bit);
+      reference.fillRect(b.low_row, b.high_row, b.low_col, b.high_col, bit);
+      break;
+    }
+    case 3: {
+      operation = "invertRect";
+      const Rect area = source.rect();
+      const Bounds b = boundsOf(area);
+      frame.invertRect(area);
+      reference.invertRect(b.low_row, b.high_row, b.low_col, b.high_col);
+      break;
+    }
+    case 4: {
+      operation = "drawSprite";
+      const Rect area = source.rect();
+      const Bounds b = boundsOf(area);
+      const int width = b.high_col - b.low_col + 1;
+      const int height = b.high_row - b.low_row + 1;
+      for (int i = 0; i < width * height; i++) {
+        sheet[i] = source.byte() & 1;
+      }
+      frame.drawSprite(sheet, area);
+      reference.drawSprite(sheet, width, 0, height - 1, 0, width - 1,
+                           b.low_row, b.low_col);
+      break;
+    }
+    case 5: {
+      operation = "drawSprite from a sheet";
+      const int stride = source.range(1, MAX_SPRITE);
+      const int rows = source.range(1, MAX_SPRITE);
+      for (int i = 0; i < stride * rows; i++) {
+        sheet[i] = source.byte() & 1;
+      }
+      const int8_t row_a = source.range(0, rows - 1);
+      const int8_t row_b = source.range(0, rows - 1);
+      const int8_t col_a = source.range(0, stride - 1);
+      const int8_t col_b = source.range(0, stride - 1);
+      const Rect area{row_a, row_b, col_a, col_b};
+      const Bounds b = boundsOf(area);
+      const int8_t row = source.coordinate();
+      const int8_t col = source.coordinate();
+      frame.drawSprite(sheet, stride, area, row, col);
+      reference.drawSprite(sheet, stride, b.low_row, b.high_row, b.low_col,
+                           b.high_col, row, col);
+      break;
+    }
+    case 6: {
+      operation = "Rect::operator&";
+      ok = checkIntersection(source.rect(), source.rect());
+      break;
+    }
+    case 7: {
+      operation = "setRow";
+      const int8_t row = source.range(-2, LMG::LED_MATRIX_HEIGHT + 1);
+      const uint16_t bits = source.word();
+      frame.setRow(row, bits);
+      reference.setRow(row, bits);
+      break;
+    }
+    case 8: {
+      operation = "setColumn";
+      const int8_t col = source.range(-2, LMG::LED_MATRIX_WIDTH + 1);
+      const uint8_t bits = source.byte();
+      frame.setColumn(col, bits);
+      reference.setColumn(col, bits);
+      break;
+    }
+    case 9: {
+      operation = "setLEDs";
+      int8_t rows[16];
+      int8_t cols[16];
+      const size_t n = source.range(0, 16);
+      for (size_t i = 0; i < n; i++) {
+        rows[i] = source.coordinate();
+        cols[i] = source.coordinate();
+      }
+      const PlotMode mode = source.plotMode();
+      frame.setLEDs(rows, cols, n, mode);
+      for (size_t i = 0; i < n; i++) {
+        reference.plot(rows[i], cols[i], mode);
+      }
+      break;
+    }
+    case 10: {
+      operation = "setLEDs with positions";
+      uint8_t positions[16];
+      const size_t n = source.range(0, 16);
+      for (size_t i = 0; i < n; i++) {
+        positions[i] = source.range(0, 110);
+      }
+      const PlotMode mode = source.plotMode();
+      frame.setLEDs(positions, n, mode);
+      for (size_t i = 0; i < n; i++) {
+        if (positions[i] < 96) {
+          reference.plot(positions[i] / LMG::LED_MATRIX_WIDTH,
+                         positions[i] % LMG::LED_MATRIX_WIDTH, mode);
+        }
+      }
+      break;
+    }
+    case 11: {
+      operation = "shiftRows";
+      const int8_t shift = source.range(-10, 10);
+      frame.shiftRows(shift);
+      reference.shiftRows(shift);
+      break;
+    }
+    case 12: {
+      operation = "shiftColumns";
+      const int8_t shift = source.range(-14, 14);
+      frame.shiftColumns(shift);
+      reference.shiftColumns(shift);
+      break;
+    }
+    case 13: {
+      operation = "lifeStep";
+      const LMG::LifeRule rule{static_cast<uint16_t>(source.word() & 0x1FF),
+                               static_cast<uint16_t>(source.word() & 0x1FF)};
+      const bool wrap = source.byte() & 1;
+      frame.lifeStep(rule, wrap);
+      reference.lifeStep(rule, wrap);
+      break;
+    }
+    case 14:
+      operation = "dilate";
+      frame.dilate();
+      reference.dilate();
+      break;
+    case 15:
+      operation = "erode";
+      frame.erode();
+      reference.erode();
+      break;
+    case 16:
+      operation = "outline";
+      frame.outline();
+      reference.outline();
+      break;
+    case 17: {
+      operation = "floodFill";
+      const int8_t row = source.range(-1, LMG::LED_MATRIX_HEIGHT);
+      const int8_t col = source.range(-1, LMG::LED_MATRIX_WIDTH);
+      frame.floodFill(row, col);
+      reference.floodFill(row, col);
+      break;
+    }
+    case 18:
+    case 19:
+    case 20: {
+      const Rect areas[3] = {source.rect(), source.rect(), source.rect()};
+      const Bounds bounds[3] = {boundsOf(areas[0]), boundsOf(areas[1]),
+                                boundsOf(areas[2])};
+      const size_t n = source.range(0, 3);
+      const Region region{areas, n};
+      const ReferenceFrame area = referenceRegion(bounds, n);
+      for (int8_t row = -1; row <= LMG::LED_MATRIX_HEIGHT; row++) {
+        for (int8_t col = -1; col <= LMG::LED_MATRIX_WIDTH; col++) {
+          ok = ok && region.contains(row, col) == area.getLED(row, col);
+        }
+      }
+      if (!ok) {
+        operation = "Region::contains";
+        break;
+      }
+      const std::array<uint32_t, 3> other = source.frameData();
+      const Frame other_frame{other.data()};
+      const ReferenceFrame other_reference{other};
+      const bool bit = source.byte() & 1;
+      const uint8_t choice = source.byte() % 3;
+      if (choice == 0) {
+        operation = "fillRegion";
+        frame.fillRegion(region, bit);
+        reference.forEachIn(area, [&](int r, int c) {
+          reference.setLED(r, c, bit);
+        });
+      } else if (choice == 1) {
+        operation = "invertRegion";
+        frame.invertRegion(region);
+        reference.forEachIn(area, [&](int r, int c) {
+          reference.invertLED(r, c);
+        });
+      } else {
+        operation = "copyRegion";
+        frame.copyRegion(other_frame, region);
+        reference.forEachIn(area, [&](int r, int c) {
+          reference.setLED(r, c, other_reference.getLED(r, c));
+        });
+      }
+      break;
+    }
+    default: {
+      operation = "Frame(raw)";
+      const std::array<uint32_t, 3> words = source.frameData();
+      frame = Frame(words.data());
+      reference = ReferenceFrame(words);
+      break;
+    }
+    }
+
+    if (!ok || !matches(frame, reference)) {
+      const uint32_t *actual = frame.getData();
+      return Failure{operation, step, reference.pack(),
+                     {actual[0], actual[1], actual[2]}};
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+#ifdef LMG_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  ByteSource source{data, size};
+  if (runProgram(source, SIZE_MAX)) {
+    std::abort();
+  }
+  return 0;
+}
+
+#else
+
+namespace {
+
+/// Number of operations in a program of the seeded runner.
+constexpr size_t PROGRAM_STEPS{64};
+
+/// Prints a frame as a grid of LEDs.
+void print(const std::array<uint32_t, 3> &words) {
+  const ReferenceFrame frame{words};
+  for (int row = 0; row < LMG::LED_MATRIX_HEIGHT; row++) {
+    std::cerr << "  ";
+    for (int col = 0; col < LMG::LED_MATRIX_WIDTH; col++) {
+      std::cerr << (frame.getLED(row, col) ? '#' : '.');
+    }
+    std::cerr << "\n";
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t programs =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  const uint32_t seed =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::random_device{}();
+
+  for (uint32_t i = 0; i < programs; i++) {
+    const uint32_t program_seed = seed + i;
+    ByteSource source{program_seed};
+    const std::optional<Failure> failure = runProgram(source, PROGRAM_STEPS);
+    if (failure) {
+      std::cerr << "mismatch in " << failure->operation << " at step "
+                << failure->step << "\nexpected:\n";
+      print(failure->expected);
+      std::cerr << "actual:\n";
+      print(failure->actual);
+      std::cerr << "replay with: " << argv[0] << " 1 " << program_seed << "\n";
+      return 1;
+    }
+  }
+  std::cerr << "ran " << programs << " programs with seed " << seed
+            << ", no mismatches\n";
+  return 0;
+}
+
+#endif
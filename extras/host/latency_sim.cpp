@@ -0,0 +1,264 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Measures the input latency of examples/Tetris on the host and fails if it
+ *  regresses.
+ *
+ *  First it checks LatencyTracer from src/LMG_Trace.h against a fixed
+ *  schedule with known latencies. Then it runs the real game code from
+ *  examples/Tetris/Tetris.h in a copy of the sketch's loop(): buttons are
+ *  read, GameState is updated, the frame is composed with drawPlaced,
+ *  drawActive and operator+, and it is loaded into a stand-in for the LED
+ *  matrix. Button presses are traced the same way as in the sketch when it is
+ *  built with LMG_TRACE_LATENCY.
+ *
+ *  The clock is simulated: it advances with the measured steady_clock time of
+ *  the code that runs, plus the time that the game passes to delay(), which
+ *  is skipped instead of slept. Every traced press waits for exactly one game
+ *  tick, so the tick is subtracted from the percentiles to get the time spent
+ *  in the code. The 99th percentile of that must stay within a budget.
+ *
+ *  Usage: latency_sim [seed] [processing budget ns]
+ *
+ *  Build: g++ -std=c++17 -O2 -Wall -Wextra -Isrc -Iexamples/Tetris \
+ *             extras/host/latency_sim.cpp src/LED_Matrix_Graphics.cpp \
+ *             -o latency_sim
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_Trace.h"
+
+namespace {
+
+/// Time that was skipped by delay(), in nanoseconds.
+uint64_t delayed_ns = 0;
+
+const std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+/// The simulated clock in nanoseconds. It wraps around after about four
+/// seconds, which the tracer handles like the wraparound of micros().
+uint32_t now() {
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() +
+      delayed_ns);
+}
+
+} // namespace
+
+/// Stand-in for the Arduino function that is called by GameState::nextTick.
+void delay(const uint32_t ms) { delayed_ns += ms * 1000000ULL; }
+
+#include "Tetris.h"
+
+namespace {
+
+/// Default 99th percentile of the time from reading a button to loading the
+/// frame that shows it, not counting the game tick. It is a few times what a
+/// desktop machine needs, so a regression of the code on the path fails the
+/// check well before the board would fall behind.
+constexpr uint32_t PROCESSING_BUDGET_NS{3000};
+
+/// Number of iterations of the game loop.
+constexpr uint32_t LOOPS{20000};
+
+constexpr uint32_t TICK_NS{GameState::MS_PER_TICK * 1000000};
+
+int failures = 0;
+
+void check(const bool condition, const char *description) {
+  if (!condition) {
+    std::cerr << "FAILED: " << description << "\n";
+    failures++;
+  }
+}
+
+void checkKnownLatencies() {
+  LMG::LatencyTracer<2, 8> tracer;
+
+  // Two inputs that are presented together get their own latencies.
+  const int8_t first = tracer.input(100);
+  const int8_t second = tracer.input(150);
+  tracer.applied(first);
+  tracer.applied(second);
+  tracer.presented(400);
+
+  // An input that is not applied yet is not shown by the next frame.
+  const int8_t late = tracer.input(500);
+  tracer.presented(600);
+  tracer.applied(late);
+  tracer.presented(1500);
+
+  // Inputs that do not fit are counted, and their identifier is ignored.
+  const int8_t a = tracer.input(2000);
+  const int8_t b = tracer.input(2000);
+  const int8_t dropped = tracer.input(2000);
+  check(dropped == -1, "input without a free slot");
+  check(tracer.overflowCount() == 1, "overflow is counted");
+  tracer.applied(dropped);
+  tracer.cancel(a);
+  tracer.cancel(b);
+  tracer.presented(2100);
+
+  const LMG::LatencyStats stats = tracer.stats();
+  check(stats.count == 3, "sample count");
+  check(stats.min == 250, "min");
+  check(stats.p50 == 300, "p50");
+  check(stats.p99 == 300, "p99");
+  check(stats.max == 1000, "max");
+
+  tracer.reset();
+  check(tracer.stats().count == 0, "reset forgets samples");
+}
+
+/// Stand-in for ArduinoLEDMatrix::loadFrame, which copies the words into the
+/// buffer that is scanned by its timer interrupt.
+volatile uint32_t matrix_buffer[3];
+
+void loadFrame(const uint32_t *buf) {
+  for (size_t i = 0; i < 3; i++) {
+    matrix_buffer[i] = buf[i];
+  }
+}
+
+/// The loop() of examples/Tetris with latency tracing, driven by random
+/// button presses. Returns the latency statistics.
+LMG::LatencyStats simulate(const uint32_t seed) {
+  std::mt19937 rng{seed};
+  srand(seed);
+
+  GameState game{};
+  game.reset();
+  LMG::LatencyTracer<4, 4096> tracer;
+  LMG::Frame placed{};
+  bool rotate_button_pushed{false};
+  bool shift_left_button_pushed{false};
+  bool shift_right_button_pushed{false};
+
+  const auto handleInput = [&](void (GameState::*action)()) {
+    const int8_t id = tracer.input(now());
+    const LMG::Frame before = game.drawActive();
+    (game.*action)();
+    if (game.drawActive() == before) {
+      tracer.cancel(id);
+    } else {
+      tracer.applied(id);
+    }
+  };
+
+  // Every button is held down in about a quarter of the iterations.
+  const auto button = [&] { return rng() % 4 == 0; };
+
+  for (uint32_t i = 0; i < LOOPS; i++) {
+    if (game.isGameOver()) {
+      game.reset();
+    }
+
+    if (button()) {
+      if (!rotate_button_pushed) {
+        handleInput(&GameState::rotatePiece);
+        rotate_button_pushed = true;
+      }
+    } else {
+      rotate_button_pushed = false;
+    }
+
+    if (button()) {
+      if (!shift_left_button_pushed) {
+        handleInput(&GameState::shiftPieceLeft);
+        shift_left_button_pushed = true;
+      }
+    } else {
+      shift_left_button_pushed = false;
+    }
+
+    if (button()) {
+      if (!shift_right_button_pushed) {
+        handleInput(&GameState::shiftPieceRight);
+        shift_right_button_pushed = true;
+      }
+    } else {
+      shift_right_button_pushed = false;
+    }
+
+    if (button()) {
+      handleInput(&GameState::tryDescend);
+    }
+
+    game.nextTick();
+    placed = game.drawPlaced();
+    loadFrame((placed + game.drawActive()).getData());
+    tracer.presented(now());
+  }
+  check(tracer.overflowCount() == 0, "no inputs dropped by the tracer");
+  return tracer.stats();
+}
+
+/// Prints a latency without the game tick.
+std::ostream &processing(std::ostream &out, const uint32_t latency) {
+  return out << (latency - TICK_NS) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t seed = argc > 1 ? std::strtoul(argv[1], nullptr, 0) : 1;
+  const uint32_t budget =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 0) : PROCESSING_BUDGET_NS;
+
+  checkKnownLatencies();
+
+  const LMG::LatencyStats stats = simulate(seed);
+  check(stats.count > 0, "latencies were recorded");
+  check(stats.min >= TICK_NS, "every traced input waits for one game tick");
+  if (failures == 0) {
+    std::cout << "seed " << seed << ": n=" << stats.count
+              << ", game tick " << GameState::MS_PER_TICK
+              << " ms plus (us) min=";
+    processing(std::cout, stats.min) << " p50=";
+    processing(std::cout, stats.p50) << " p99=";
+    processing(std::cout, stats.p99) << " max=";
+    processing(std::cout, stats.max) << "\n";
+    if (stats.p99 - TICK_NS > budget) {
+      std::cerr << "p99 latency exceeds the budget of " << budget
+                << " ns on top of the game tick\n";
+      failures++;
+    }
+  }
+
+  if (failures > 0) {
+    std::cerr << failures << " checks failed\n";
+    return 1;
+  }
+  std::cerr << "all checks passed\n";
+  return 0;
+}
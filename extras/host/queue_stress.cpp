@@ -0,0 +1,184 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Stress test for FrameQueue from src/LMG_FrameQueue.h. A producer thread
+ *  pushes numbered frames as fast as it can while a consumer thread pops
+ *  them, once for every overflow policy. For each run it checks that:
+ *
+ *  - no frame was torn, i.e. the three words of every popped frame belong
+ *    to the same pushed frame;
+ *  - frames come out in the order they were pushed;
+ *  - every frame is accounted for: popped + dropped == pushed;
+ *  - DropNewest delivers exactly the frames that push accepted, and the
+ *    other policies always deliver the newest frame.
+ *
+ *  It also prints the throughput of every run.
+ *
+ *  Usage: queue_stress [frames per run]
+ *
+ *  Build: g++ -std=c++17 -O2 -pthread -Isrc extras/host/queue_stress.cpp \
+ *             src/LED_Matrix_Graphics.cpp -o queue_stress
+ *
+ *  Add -fsanitize=thread to check the memory ordering with ThreadSanitizer.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_FrameQueue.h"
+
+namespace {
+
+/// Capacity of the queue, kept small so that it overflows often.
+constexpr size_t CAPACITY{4};
+
+/// Builds a frame whose three words all depend on the sequence number, so
+/// that a torn read is detected.
+LMG::Frame numberedFrame(const uint32_t number) {
+  const uint32_t raw[3] = {number, ~number, number * 0x9E3779B9u};
+  return LMG::Frame{raw};
+}
+
+/// Returns the sequence number of a frame, or false if the frame is torn.
+bool frameNumber(const LMG::Frame &frame, uint32_t &number) {
+  const uint32_t *raw = frame.getData();
+  number = raw[0];
+  return raw[1] == ~number && raw[2] == number * 0x9E3779B9u;
+}
+
+const char *policyName(const LMG::OverflowPolicy policy) {
+  switch (policy) {
+  case LMG::OverflowPolicy::DropOldest:
+    return "DropOldest";
+  case LMG::OverflowPolicy::DropNewest:
+    return "DropNewest";
+  case LMG::OverflowPolicy::CoalesceLatest:
+    return "CoalesceLatest";
+  }
+  return "";
+}
+
+/// Runs the producer and consumer for one policy.
+/**
+ * @returns True, if every check passed.
+ */
+bool run(const LMG::OverflowPolicy policy, const uint32_t frames) {
+  LMG::FrameQueue<CAPACITY> queue{policy};
+  std::atomic<bool> producer_done{false};
+
+  // Frames that push accepted, and the sum of their numbers, to compare with
+  // what the consumer saw under DropNewest.
+  uint32_t accepted = 0;
+  uint64_t accepted_sum = 0;
+
+  uint32_t popped = 0;
+  uint64_t popped_sum = 0;
+  uint32_t last_popped = 0;
+  bool in_order = true;
+  bool intact = true;
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::thread consumer([&] {
+    LMG::Frame frame{};
+    bool first = true;
+    while (true) {
+      // Checks the flag before popping, so that no frame is left behind.
+      const bool done = producer_done.load(std::memory_order_acquire);
+      if (!queue.pop(frame)) {
+        if (done) {
+          return;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      uint32_t number = 0;
+      if (!frameNumber(frame, number)) {
+        intact = false;
+        continue;
+      }
+      if (!first && number <= last_popped) {
+        in_order = false;
+      }
+      first = false;
+      last_popped = number;
+      popped++;
+      popped_sum += number;
+    }
+  });
+
+  for (uint32_t number = 1; number <= frames; number++) {
+    if (queue.push(numberedFrame(number))) {
+      accepted++;
+      accepted_sum += number;
+    }
+    // Gives the consumer a chance to run on machines with a single core.
+    if (number % 64 == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer_done.store(true, std::memory_order_release);
+  consumer.join();
+
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  const uint32_t dropped = queue.droppedCount();
+
+  bool ok = intact && in_order && popped + dropped == frames;
+  if (policy == LMG::OverflowPolicy::DropNewest) {
+    ok = ok && popped == accepted && popped_sum == accepted_sum;
+  } else {
+    ok = ok && accepted == frames && last_popped == frames;
+  }
+
+  std::cout << policyName(policy) << ": " << frames << " pushed, " << popped
+            << " popped, " << dropped << " dropped, "
+            << static_cast<uint64_t>(frames / seconds) << " frames/s"
+            << (intact ? "" : ", TORN FRAMES")
+            << (in_order ? "" : ", OUT OF ORDER")
+            << (ok ? "" : ", FAILED") << "\n";
+  return ok;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t frames =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  bool ok = true;
+  for (const LMG::OverflowPolicy policy :
+       {LMG::OverflowPolicy::DropOldest, LMG::OverflowPolicy::DropNewest,
+        LMG::OverflowPolicy::CoalesceLatest}) {
+    ok = run(policy, frames) && ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Renders an animation of ripples spreading from the center of the matrix
+ *  into a frame file, using every core of the machine.
+ *
+ *  Usage: render_ripple <output file> <frame count> [threads]
+ *
+ *  Build: g++ -std=c++17 -O2 -pthread -Isrc -Iextras/host \
+ *             extras/host/render_ripple.cpp src/LED_Matrix_Graphics.cpp \
+ *             -o render_ripple
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_Render.h"
+
+namespace {
+
+/// Draws the ripples at a given frame index. Only integer arithmetic is used,
+/// so the result is the same on every machine.
+LMG::Frame drawRipple(const uint32_t index) {
+  LMG::Frame frame{};
+  for (int8_t row = 0; row < LMG::LED_MATRIX_HEIGHT; row++) {
+    for (int8_t col = 0; col < LMG::LED_MATRIX_WIDTH; col++) {
+      // Doubled distances from the center, which lies between four LEDs.
+      const int32_t d_row = 2 * row - (LMG::LED_MATRIX_HEIGHT - 1);
+      const int32_t d_col = 2 * col - (LMG::LED_MATRIX_WIDTH - 1);
+      const int32_t dist_sq = d_row * d_row + d_col * d_col;
+
+      // Integer square root, so that the rings are evenly spaced.
+      int32_t dist = 0;
+      while ((dist + 1) * (dist + 1) <= dist_sq) {
+        dist++;
+      }
+      frame.setLED(row, col, (dist + 64 - index % 64) % 8 < 2);
+    }
+  }
+  return frame;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " <output file> <frame count> "
+              << "[threads]\n";
+    return 1;
+  }
+  const uint32_t count = std::strtoul(argv[2], nullptr, 10);
+  const unsigned threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+
+  std::ofstream out(argv[1], std::ios::binary);
+  if (!LMG::renderAnimation(out, drawRipple, count, threads)) {
+    std::cerr << "failed to write " << argv[1] << "\n";
+    return 1;
+  }
+  return 0;
+}
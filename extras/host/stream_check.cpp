@@ -0,0 +1,191 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Checks the streaming protocol from src/LMG_Stream.h without a serial port:
+ *  round trips of random frames, recovery from corrupted and dropped bytes,
+ *  and resynchronisation on sync bytes that show up in the middle of a
+ *  broken packet.
+ *
+ *  Usage: stream_check [seed]
+ *
+ *  Build: g++ -std=c++17 -O2 -Isrc extras/host/stream_check.cpp \
+ *             src/LMG_Stream.cpp src/LED_Matrix_Graphics.cpp -o stream_check
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_Stream.h"
+
+namespace {
+
+int failures = 0;
+
+void check(const bool condition, const char *description) {
+  if (!condition) {
+    std::cerr << "FAILED: " << description << "\n";
+    failures++;
+  }
+}
+
+/// Feeds bytes to a decoder and returns how many packets were applied.
+uint32_t feedAll(LMG::StreamDecoder &decoder,
+                 const std::vector<uint8_t> &bytes) {
+  uint32_t applied = 0;
+  for (const uint8_t byte : bytes) {
+    applied += decoder.feed(byte);
+  }
+  return applied;
+}
+
+LMG::Frame randomFrame(std::mt19937 &rng) {
+  const uint32_t raw[3] = {static_cast<uint32_t>(rng()),
+                           static_cast<uint32_t>(rng()),
+                           static_cast<uint32_t>(rng())};
+  return LMG::Frame{raw};
+}
+
+std::vector<uint8_t> keyframe(const LMG::Frame &frame, const uint8_t seq) {
+  uint8_t packet[LMG::STREAM_MAX_PACKET];
+  const size_t size = LMG::encodeKeyframe(frame, seq, packet);
+  return std::vector<uint8_t>(packet, packet + size);
+}
+
+/// A sync byte inside a broken header must start the next packet.
+void checkResync(std::mt19937 &rng) {
+  const LMG::Frame expected = randomFrame(rng);
+  const std::vector<uint8_t> packet = keyframe(expected, 7);
+
+  // A delta whose bitmap starts with 0xA5 is malformed, and the 0xA5 is the
+  // start of a valid keyframe.
+  std::vector<uint8_t> bytes = {LMG::STREAM_SYNC, LMG::STREAM_DELTA, 0x33};
+  bytes.insert(bytes.end(), packet.begin(), packet.end());
+  LMG::Frame frame{};
+  LMG::StreamDecoder decoder{frame};
+  check(feedAll(decoder, bytes) == 1, "resync after a malformed bitmap");
+  check(frame == expected, "frame after a malformed bitmap");
+  check(decoder.crcErrorCount() == 1, "errors after a malformed bitmap");
+
+  // An unknown packet type followed by a real packet.
+  bytes = {LMG::STREAM_SYNC, 0x7F};
+  bytes.insert(bytes.end(), packet.begin(), packet.end());
+  LMG::Frame other{};
+  LMG::StreamDecoder other_decoder{other};
+  check(feedAll(other_decoder, bytes) == 1, "resync after a bad type");
+  check(other == expected, "frame after a bad type");
+
+  // A packet that lost its checksum byte, so the 0xA5 of the next packet is
+  // read in its place.
+  std::vector<uint8_t> truncated;
+  do {
+    truncated = keyframe(randomFrame(rng), 6);
+  } while (truncated.back() == LMG::STREAM_SYNC);
+  truncated.pop_back();
+  bytes = truncated;
+  bytes.insert(bytes.end(), packet.begin(), packet.end());
+  LMG::Frame after_crc{};
+  LMG::StreamDecoder crc_decoder{after_crc};
+  check(feedAll(crc_decoder, bytes) == 1, "resync after a bad checksum");
+  check(after_crc == expected, "frame after a bad checksum");
+  check(crc_decoder.crcErrorCount() == 1, "errors after a bad checksum");
+}
+
+/// Sends a sequence of keyframes and deltas, optionally damaging one byte,
+/// and checks that every frame that is shown was actually sent and that the
+/// stream ends in sync.
+void checkStream(std::mt19937 &rng, const int damage) {
+  std::vector<LMG::Frame> sent;
+  std::vector<uint8_t> bytes;
+  LMG::Frame previous{};
+  for (uint8_t i = 0; i < 20; i++) {
+    LMG::Frame frame = randomFrame(rng);
+    if (i % 3 != 0) {
+      // Small changes, as in an animation.
+      frame = previous;
+      frame.invertLED(rng() % 8, rng() % 12);
+    }
+    uint8_t packet[LMG::STREAM_MAX_PACKET];
+    const size_t size = i % 5 == 0 ? LMG::encodeKeyframe(frame, i, packet)
+                                    : LMG::encodeDelta(previous, frame, i,
+                                                       packet);
+    bytes.insert(bytes.end(), packet, packet + size);
+    sent.push_back(frame);
+    previous = frame;
+  }
+
+  // The damage happens in the first half of the stream, well before the last
+  // keyframe, so the stream recovers.
+  const size_t at = rng() % (bytes.size() / 2);
+  if (damage == 1) {
+    bytes[at] ^= 1 << (rng() % 8);
+  } else if (damage == 2) {
+    bytes.erase(bytes.begin() + at);
+  }
+
+  LMG::Frame frame{};
+  LMG::StreamDecoder decoder{frame};
+  bool only_sent_frames = true;
+  for (const uint8_t byte : bytes) {
+    if (!decoder.feed(byte)) {
+      continue;
+    }
+    bool found = false;
+    for (const LMG::Frame &candidate : sent) {
+      found = found || candidate == frame;
+    }
+    only_sent_frames = only_sent_frames && found;
+  }
+
+  // An 8-bit checksum lets about one in 256 misframed packets through, so a
+  // wrong frame is only an error without damage.
+  if (damage == 0) {
+    check(only_sent_frames, "frames of an undamaged stream");
+  }
+  check(frame == sent.back(), "final frame of the stream");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const uint32_t seed =
+      argc > 1 ? std::strtoul(argv[1], nullptr, 10) : std::random_device{}();
+  std::mt19937 rng{seed};
+
+  checkResync(rng);
+  for (int i = 0; i < 3000; i++) {
+    checkStream(rng, i % 3);
+  }
+
+  if (failures > 0) {
+    std::cerr << failures << " checks failed with seed " << seed << "\n";
+    return 1;
+  }
+  std::cerr << "all checks passed with seed " << seed << "\n";
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Receives frames sent by stream_sender and writes them to a frame file. It
+ *  uses the same decoder as the SerialStream example, so the two tools can be
+ *  connected through a pseudo-terminal pair to test the protocol end to end:
+ *
+ *  socat -d -d pty,raw,echo=0 pty,raw,echo=0   # prints two /dev/pts paths
+ *  stream_receiver /dev/pts/A 115200 out.bin 1000 &
+ *  stream_sender /dev/pts/B 115200 in.bin
+ *  cmp in.bin out.bin
+ *
+ *  Usage: stream_receiver <serial port> <baud> <frame file> <frame count>
+ *
+ *  Build: g++ -std=c++17 -O2 -Isrc -Iextras/host \
+ *             extras/host/stream_receiver.cpp src/LMG_Stream.cpp \
+ *             src/LED_Matrix_Graphics.cpp -o stream_receiver
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_FrameFile.h"
+#include "LMG_SerialPort.h"
+#include "LMG_Stream.h"
+
+int main(int argc, char **argv) {
+  if (argc < 5) {
+    std::cerr << "usage: " << argv[0]
+              << " <serial port> <baud> <frame file> <frame count>\n";
+    return 1;
+  }
+  const uint32_t baud = std::strtoul(argv[2], nullptr, 10);
+  const uint32_t expected = std::strtoul(argv[4], nullptr, 10);
+
+  const int fd = LMG::openSerialPort(argv[1], baud);
+  if (fd < 0) {
+    std::cerr << "failed to open " << argv[1] << " at " << baud << " baud\n";
+    return 1;
+  }
+  std::ofstream out(argv[3], std::ios::binary);
+
+  LMG::Frame frame{};
+  LMG::StreamDecoder decoder{frame};
+  uint32_t count = 0;
+  uint8_t buffer[256];
+  while (count < expected) {
+    const ssize_t received = read(fd, buffer, sizeof(buffer));
+    if (received <= 0) {
+      break;
+    }
+    for (ssize_t i = 0; i < received && count < expected; i++) {
+      if (decoder.feed(buffer[i])) {
+        LMG::writeFrame(out, frame);
+        count++;
+      }
+    }
+  }
+  close(fd);
+
+  std::cerr << "received " << count << " frames, " << decoder.crcErrorCount()
+            << " checksum errors, " << decoder.skippedCount()
+            << " skipped deltas\n";
+  return count == expected ? 0 : 1;
+}
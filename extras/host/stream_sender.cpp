@@ -0,0 +1,131 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+/*
+ *  Streams a frame file to an Arduino running the SerialStream example, using
+ *  the protocol from src/LMG_Stream.h.
+ *
+ *  Usage: stream_sender <serial port> <baud> <frame file> [fps] [keyframe
+ *         interval]
+ *
+ *  With an fps of 0 (the default), frames are sent as fast as the serial
+ *  link accepts them. Every `keyframe interval` frames (default 30), a full
+ *  frame is sent instead of a delta, so that the display recovers from lost
+ *  bytes.
+ *
+ *  Build: g++ -std=c++17 -O2 -Isrc -Iextras/host \
+ *             extras/host/stream_sender.cpp src/LMG_Stream.cpp \
+ *             src/LED_Matrix_Graphics.cpp -o stream_sender
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "LED_Matrix_Graphics.h"
+#include "LMG_FrameFile.h"
+#include "LMG_SerialPort.h"
+#include "LMG_Stream.h"
+
+namespace {
+
+/// Writes all of the bytes, retrying after partial writes.
+bool writeAll(const int fd, const uint8_t *bytes, size_t size) {
+  while (size > 0) {
+    const ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      return false;
+    }
+    bytes += written;
+    size -= written;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 4) {
+    std::cerr << "usage: " << argv[0] << " <serial port> <baud> <frame file> "
+              << "[fps] [keyframe interval]\n";
+    return 1;
+  }
+  const uint32_t baud = std::strtoul(argv[2], nullptr, 10);
+  const uint32_t fps = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 0;
+  const uint32_t keyframe_interval =
+      argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 30;
+
+  const int fd = LMG::openSerialPort(argv[1], baud);
+  if (fd < 0) {
+    std::cerr << "failed to open " << argv[1] << " at " << baud << " baud\n";
+    return 1;
+  }
+  std::ifstream in(argv[3], std::ios::binary);
+  if (!in) {
+    std::cerr << "failed to open " << argv[3] << "\n";
+    return 1;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  auto next_frame = start;
+
+  LMG::Frame previous{};
+  LMG::Frame frame{};
+  uint8_t packet[LMG::STREAM_MAX_PACKET];
+  uint32_t count = 0;
+  uint64_t bytes_sent = 0;
+  while (LMG::readFrame(in, frame)) {
+    const uint8_t seq = static_cast<uint8_t>(count);
+    const bool keyframe =
+        count == 0 || keyframe_interval == 0 || count % keyframe_interval == 0;
+    const size_t size = keyframe
+                            ? LMG::encodeKeyframe(frame, seq, packet)
+                            : LMG::encodeDelta(previous, frame, seq, packet);
+    if (!writeAll(fd, packet, size)) {
+      std::cerr << "failed to write to " << argv[1] << "\n";
+      return 1;
+    }
+    bytes_sent += size;
+    previous = frame;
+    count++;
+
+    if (fps > 0) {
+      next_frame += std::chrono::microseconds(1000000 / fps);
+      std::this_thread::sleep_until(next_frame);
+    }
+  }
+  tcdrain(fd);
+  close(fd);
+
+  const double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  std::cerr << "sent " << count << " frames (" << bytes_sent << " bytes) in "
+            << seconds << " s, " << count / seconds << " fps, "
+            << static_cast<double>(bytes_sent) / count << " bytes/frame\n";
+  return 0;
+}
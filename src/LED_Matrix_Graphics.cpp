@@ -24,6 +24,8 @@
 
 #include "LED_Matrix_Graphics.h"
 
+#include <algorithm>
+
 namespace LMG {
 
 Rect::Rect(int8_t row_a, int8_t row_b, int8_t col_a, int8_t col_b)
@@ -74,9 +76,103 @@ void Rect::shiftColumns(int8_t shift) {
   high_col += shift;
 }
 
-const uint32_t *Frame::getData() { return data.data(); }
+uint16_t Frame::rowMask(const int8_t low_col, const int8_t high_col) {
+  return (ROW_BITS >> low_col) & ~(ROW_BITS >> (high_col + 1));
+}
+
+uint16_t Frame::readRowBits(const int8_t row) const {
+  const int8_t pos = row * LED_MATRIX_WIDTH;
+  const int8_t data_index = pos >> 5;
+  const int8_t rem = pos % 32;
+
+  // See writeRowBits for the meaning of the shift.
+  const int8_t shift = 32 - LED_MATRIX_WIDTH - rem;
+  if (shift >= 0) {
+    return (data[data_index] >> shift) & ROW_BITS;
+  }
+  const int8_t spill = -shift;
+  return ((data[data_index] << spill) |
+          (data[data_index + 1] >> (32 - spill))) &
+         ROW_BITS;
+}
+
+void Frame::writeRowBits(const int8_t row, const uint16_t bits,
+                         const uint16_t mask) {
+  const int8_t pos = row * LED_MATRIX_WIDTH;
+  const int8_t data_index = pos >> 5;
+  const int8_t rem = pos % 32;
+
+  // Number of bits by which the row has to be shifted left to line up with its
+  // position in the data word. Negative values mean that the row straddles two
+  // words (this happens for rows 2 and 5).
+  const int8_t shift = 32 - LED_MATRIX_WIDTH - rem;
+  if (shift >= 0) {
+    const uint32_t word_mask = static_cast<uint32_t>(mask) << shift;
+    data[data_index] = (data[data_index] & ~word_mask) |
+                       ((static_cast<uint32_t>(bits) << shift) & word_mask);
+  } else {
+    const int8_t spill = -shift;
+    const uint32_t high_mask = static_cast<uint32_t>(mask) >> spill;
+    data[data_index] = (data[data_index] & ~high_mask) |
+                       ((static_cast<uint32_t>(bits) >> spill) & high_mask);
+    const uint32_t low_mask = static_cast<uint32_t>(mask) << (32 - spill);
+    data[data_index + 1] =
+        (data[data_index + 1] & ~low_mask) |
+        ((static_cast<uint32_t>(bits) << (32 - spill)) & low_mask);
+  }
+}
+
+std::array<uint32_t, 3> Frame::leadingBits(const int8_t count) {
+  std::array<uint32_t, 3> bits{0, 0, 0};
+  for (int8_t i = 0; i < 3; i++) {
+    const int8_t in_word = count - 32 * i;
+    if (in_word >= 32) {
+      bits[i] = UINT32_MAX;
+    } else if (in_word > 0) {
+      bits[i] = ~(UINT32_MAX >> in_word);
+    }
+  }
+  return bits;
+}
+
+std::array<uint32_t, 3> Frame::shiftBits(const std::array<uint32_t, 3> &bits,
+                                         const int8_t shift) {
+  std::array<uint32_t, 3> shifted{0, 0, 0};
+  if (shift >= 96 || shift <= -96) {
+    return shifted;
+  }
+
+  // Splits the shift into whole words and the remaining bits.
+  const int8_t distance = shift < 0 ? -shift : shift;
+  const int8_t words = distance >> 5;
+  const int8_t rem = distance % 32;
+
+  for (int8_t i = 0; i < 3; i++) {
+    // Index of the word that supplies the bulk of the bits for word i, and of
+    // its neighbour that supplies the bits which cross the word boundary.
+    const int8_t source = shift > 0 ? i - words : i + words;
+    const int8_t carry = shift > 0 ? source - 1 : source + 1;
+    if (source < 0 || source > 2) {
+      continue;
+    }
+    if (shift > 0) {
+      shifted[i] = bits[source] >> rem;
+      if (rem != 0 && carry >= 0) {
+        shifted[i] |= bits[carry] << (32 - rem);
+      }
+    } else {
+      shifted[i] = bits[source] << rem;
+      if (rem != 0 && carry <= 2) {
+        shifted[i] |= bits[carry] >> (32 - rem);
+      }
+    }
+  }
+  return shifted;
+}
+
+const uint32_t *Frame::getData() const { return data.data(); }
 
-Frame Frame::operator+(const Frame &other) {
+Frame Frame::operator+(const Frame &other) const {
   Frame sum = Frame();
   for (size_t i = 0; i < 3; i++) {
     sum.data[i] = data[i] | other.data[i];
@@ -84,7 +180,7 @@ Frame Frame::operator+(const Frame &other) {
   return sum;
 }
 
-Frame Frame::operator&(const Frame &other) {
+Frame Frame::operator&(const Frame &other) const {
   Frame intersection = Frame();
   for (size_t i = 0; i < 3; i++) {
     intersection.data[i] = data[i] & other.data[i];
@@ -92,33 +188,534 @@ Frame Frame::operator&(const Frame &other) {
   return intersection;
 }
 
-Frame::operator bool() { return data[0] || data[1] || data[2]; }
+Frame Frame::operator^(const Frame &other) const {
+  Frame difference = Frame();
+  for (size_t i = 0; i < 3; i++) {
+    difference.data[i] = data[i] ^ other.data[i];
+  }
+  return difference;
+}
+
+Frame::operator bool() const { return data[0] || data[1] || data[2]; }
 
-void Frame::fillRect(const Rect &area, const bool bit) {
-  for (int8_t col = area.low_col; col <= area.high_col; col++) {
-    for (int8_t row = area.low_row; row <= area.high_row; row++) {
-      setLED(row, col, bit);
+namespace {
+
+/// Counts the set bits of a word.
+uint8_t countBits(uint32_t word) {
+  // Adds up neighbouring groups of 1, 2 and 4 bits, then sums the four bytes
+  // with a multiplication.
+  word = word - ((word >> 1) & 0x55555555);
+  word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+  word = (word + (word >> 4)) & 0x0F0F0F0F;
+  return (word * 0x01010101) >> 24;
+}
+
+} // namespace
+
+uint8_t Frame::count() const {
+  return countBits(data[0]) + countBits(data[1]) + countBits(data[2]);
+}
+
+bool Frame::operator==(const Frame &other) const {
+  return ((data[0] ^ other.data[0]) | (data[1] ^ other.data[1]) |
+          (data[2] ^ other.data[2])) == 0;
+}
+
+bool Frame::operator!=(const Frame &other) const { return !(*this == other); }
+
+uint32_t Frame::hash() const {
+  // Folds the words in one by one and finishes with the MurmurHash3
+  // finalizer, which spreads every input bit over the whole hash.
+  uint32_t h = 0x9E3779B9;
+  for (size_t i = 0; i < 3; i++) {
+    h = (h ^ data[i]) * 0x85EBCA6B;
+    h ^= h >> 13;
+  }
+  h ^= h >> 16;
+  h *= 0xC2B2AE35;
+  h ^= h >> 16;
+  return h;
+}
+
+std::array<uint32_t, 3>
+Frame::shiftedRows(const std::array<uint32_t, 3> &bits, const int8_t shift,
+                   const bool wrap) {
+  constexpr int8_t TOTAL_BITS = LED_MATRIX_HEIGHT * LED_MATRIX_WIDTH;
+  const int8_t distance = shift * LED_MATRIX_WIDTH;
+  std::array<uint32_t, 3> shifted = shiftBits(bits, distance);
+  if (wrap && shift != 0) {
+    // Rows always line up with the ends of the array, so the wrapped rows can
+    // be brought back with a second shift in the opposite direction.
+    const std::array<uint32_t, 3> wrapped = shiftBits(
+        bits, shift > 0 ? distance - TOTAL_BITS : distance + TOTAL_BITS);
+    for (size_t i = 0; i < 3; i++) {
+      shifted[i] |= wrapped[i];
+    }
+  }
+  return shifted;
+}
+
+std::array<uint32_t, 3>
+Frame::shiftedColumns(const std::array<uint32_t, 3> &bits, const int8_t shift,
+                      const bool wrap) {
+  if (shift == 0) {
+    return bits;
+  }
+
+  // Shifting the whole array moves the edge of every row into its neighbour,
+  // so the columns that crossed a row boundary have to be masked.
+  const uint16_t kept = shift > 0
+                            ? rowMask(shift, LED_MATRIX_WIDTH - 1)
+                            : rowMask(0, LED_MATRIX_WIDTH - 1 + shift);
+  const std::array<uint32_t, 3> kept_mask = repeatRow(kept);
+  std::array<uint32_t, 3> shifted = shiftBits(bits, shift);
+  for (size_t i = 0; i < 3; i++) {
+    shifted[i] &= kept_mask[i];
+  }
+
+  if (wrap) {
+    // The wrapped columns stay in the same row, which is exactly one row
+    // width away from where the plain shift puts them.
+    const std::array<uint32_t, 3> wrapped_mask = repeatRow(ROW_BITS & ~kept);
+    const std::array<uint32_t, 3> wrapped =
+        shiftBits(bits, shift > 0 ? shift - LED_MATRIX_WIDTH
+                                  : shift + LED_MATRIX_WIDTH);
+    for (size_t i = 0; i < 3; i++) {
+      shifted[i] |= wrapped[i] & wrapped_mask[i];
+    }
+  }
+  return shifted;
+}
+
+std::array<uint32_t, 3> Frame::dilated(const std::array<uint32_t, 3> &bits,
+                                       const bool diagonal) {
+  const std::array<uint32_t, 3> west = shiftedColumns(bits, 1, false);
+  const std::array<uint32_t, 3> east = shiftedColumns(bits, -1, false);
+  std::array<uint32_t, 3> horizontal{0, 0, 0};
+  for (size_t i = 0; i < 3; i++) {
+    horizontal[i] = bits[i] | west[i] | east[i];
+  }
+
+  // Spreading the horizontally dilated rows up and down also covers the
+  // diagonal neighbours, so only the plain rows are spread otherwise.
+  const std::array<uint32_t, 3> &spread = diagonal ? horizontal : bits;
+  const std::array<uint32_t, 3> north = shiftedRows(spread, -1, false);
+  const std::array<uint32_t, 3> south = shiftedRows(spread, 1, false);
+  for (size_t i = 0; i < 3; i++) {
+    horizontal[i] |= north[i] | south[i];
+  }
+  return horizontal;
+}
+
+void Frame::shiftRows(const int8_t shift) {
+  if (shift >= LED_MATRIX_HEIGHT || shift <= -LED_MATRIX_HEIGHT) {
+    data = {0, 0, 0};
+    return;
+  }
+  data = shiftedRows(data, shift, false);
+}
+
+void Frame::shiftColumns(const int8_t shift) {
+  if (shift >= LED_MATRIX_WIDTH || shift <= -LED_MATRIX_WIDTH) {
+    data = {0, 0, 0};
+    return;
+  }
+  data = shiftedColumns(data, shift, false);
+}
+
+void Frame::lifeStep(const LifeRule &rule, const bool wrap) {
+  using Bits = std::array<uint32_t, 3>;
+
+  // The eight neighbours of every cell, each as a shifted copy of the frame.
+  const Bits west = shiftedColumns(data, 1, wrap);
+  const Bits east = shiftedColumns(data, -1, wrap);
+  const Bits neighbours[8] = {
+      west,
+      east,
+      shiftedRows(data, 1, wrap),
+      shiftedRows(data, -1, wrap),
+      shiftedRows(west, 1, wrap),
+      shiftedRows(west, -1, wrap),
+      shiftedRows(east, 1, wrap),
+      shiftedRows(east, -1, wrap),
+  };
+
+  for (size_t i = 0; i < 3; i++) {
+    const uint32_t n0 = neighbours[0][i];
+    const uint32_t n1 = neighbours[1][i];
+    const uint32_t n2 = neighbours[2][i];
+    const uint32_t n3 = neighbours[3][i];
+    const uint32_t n4 = neighbours[4][i];
+    const uint32_t n5 = neighbours[5][i];
+    const uint32_t n6 = neighbours[6][i];
+    const uint32_t n7 = neighbours[7][i];
+
+    // Adds up the eight neighbours with a tree of full and half adders. The
+    // result is a four-bit count for every cell, stored as four bit planes.
+    const uint32_t sum_a = n0 ^ n1 ^ n2;
+    const uint32_t carry_a = (n0 & n1) | (n2 & (n0 ^ n1));
+    const uint32_t sum_b = n3 ^ n4 ^ n5;
+    const uint32_t carry_b = (n3 & n4) | (n5 & (n3 ^ n4));
+    const uint32_t sum_c = n6 ^ n7;
+    const uint32_t carry_c = n6 & n7;
+
+    const uint32_t ones = sum_a ^ sum_b ^ sum_c;
+    const uint32_t carry_d = (sum_a & sum_b) | (sum_c & (sum_a ^ sum_b));
+
+    const uint32_t sum_e = carry_a ^ carry_b ^ carry_c;
+    const uint32_t carry_e =
+        (carry_a & carry_b) | (carry_c & (carry_a ^ carry_b));
+    const uint32_t twos = sum_e ^ carry_d;
+    const uint32_t carry_f = sum_e & carry_d;
+
+    const uint32_t fours = carry_e ^ carry_f;
+    const uint32_t eights = carry_e & carry_f;
+
+    // Selects the cells whose neighbour count satisfies the rule.
+    uint32_t born = 0;
+    uint32_t survived = 0;
+    for (uint8_t count = 0; count <= 8; count++) {
+      const bool births = rule.birth & (1 << count);
+      const bool survives = rule.survival & (1 << count);
+      if (!births && !survives) {
+        continue;
+      }
+      const uint32_t matches = (count & 1 ? ones : ~ones) &
+                               (count & 2 ? twos : ~twos) &
+                               (count & 4 ? fours : ~fours) &
+                               (count & 8 ? eights : ~eights);
+      if (births) {
+        born |= matches;
+      }
+      if (survives) {
+        survived |= matches;
+      }
+    }
+    data[i] = (~data[i] & born) | (data[i] & survived);
+  }
+}
+
+void Frame::dilate() { data = dilated(data, true); }
+
+void Frame::erode() {
+  // Eroding the lit LEDs is the same as dilating the unlit ones. The shifts
+  // never bring in anything from outside the matrix, so the LEDs on the edges
+  // are cleared separately with a mask of the inner 6x10 LEDs.
+  constexpr std::array<uint32_t, 3> INNER = {0x0007FE7F, 0xE7FE7FE7,
+                                             0xFE7FE000};
+  std::array<uint32_t, 3> unlit{~data[0], ~data[1], ~data[2]};
+  unlit = dilated(unlit, true);
+  for (size_t i = 0; i < 3; i++) {
+    data[i] &= ~unlit[i] & INNER[i];
+  }
+}
+
+void Frame::outline() {
+  const std::array<uint32_t, 3> grown = dilated(data, true);
+  for (size_t i = 0; i < 3; i++) {
+    data[i] ^= grown[i];
+  }
+}
+
+void Frame::floodFill(const int8_t row, const int8_t col) {
+  const bool valid_row = row < LED_MATRIX_HEIGHT && row >= 0;
+  const bool valid_col = col < LED_MATRIX_WIDTH && col >= 0;
+  if (!valid_row || !valid_col) {
+    return;
+  }
+
+  constexpr uint32_t TOP_BIT = 1L << 31;
+  const int8_t pos = row * LED_MATRIX_WIDTH + col;
+  std::array<uint32_t, 3> filled{0, 0, 0};
+  filled[pos >> 5] = (TOP_BIT >> (pos % 32)) & ~data[pos >> 5];
+
+  // Grows the filled area one step at a time, but never into lit LEDs. The
+  // area can grow at most once per LED, so the loop is bounded.
+  bool growing = filled[0] || filled[1] || filled[2];
+  while (growing) {
+    const std::array<uint32_t, 3> grown = dilated(filled, false);
+    growing = false;
+    for (size_t i = 0; i < 3; i++) {
+      const uint32_t next = grown[i] & ~data[i];
+      growing = growing || next != filled[i];
+      filled[i] = next;
     }
   }
+
+  for (size_t i = 0; i < 3; i++) {
+    data[i] |= filled[i];
+  }
+}
+
+namespace {
+
+/// Applies the changes collected by Frame::setLEDs to the frame data.
+void applyPlot(std::array<uint32_t, 3> &data,
+               const std::array<uint32_t, 3> &mask, const PlotMode mode) {
+  for (size_t i = 0; i < 3; i++) {
+    switch (mode) {
+    case PlotMode::Set:
+      data[i] |= mask[i];
+      break;
+    case PlotMode::Clear:
+      data[i] &= ~mask[i];
+      break;
+    case PlotMode::Toggle:
+      data[i] ^= mask[i];
+      break;
+    }
+  }
+}
+
+} // namespace
+
+void Frame::setLEDs(const int8_t *rows, const int8_t *cols, const size_t n,
+                    const PlotMode mode) {
+  constexpr uint32_t TOP_BIT = 1L << 31;
+  std::array<uint32_t, 3> mask{0, 0, 0};
+  for (size_t i = 0; i < n; i++) {
+    // Negative coordinates become large when cast to unsigned, so a single
+    // comparison checks both bounds.
+    const uint8_t row = rows[i];
+    const uint8_t col = cols[i];
+    if (row < LED_MATRIX_HEIGHT && col < LED_MATRIX_WIDTH) {
+      const uint8_t pos = row * LED_MATRIX_WIDTH + col;
+      if (mode == PlotMode::Toggle) {
+        mask[pos >> 5] ^= TOP_BIT >> (pos % 32);
+      } else {
+        mask[pos >> 5] |= TOP_BIT >> (pos % 32);
+      }
+    }
+  }
+  applyPlot(data, mask, mode);
+}
+
+void Frame::setLEDs(const uint8_t *positions, const size_t n,
+                    const PlotMode mode) {
+  constexpr uint32_t TOP_BIT = 1L << 31;
+  constexpr uint8_t TOTAL_LEDS = LED_MATRIX_HEIGHT * LED_MATRIX_WIDTH;
+  std::array<uint32_t, 3> mask{0, 0, 0};
+  for (size_t i = 0; i < n; i++) {
+    const uint8_t pos = positions[i];
+    if (pos < TOTAL_LEDS) {
+      if (mode == PlotMode::Toggle) {
+        mask[pos >> 5] ^= TOP_BIT >> (pos % 32);
+      } else {
+        mask[pos >> 5] |= TOP_BIT >> (pos % 32);
+      }
+    }
+  }
+  applyPlot(data, mask, mode);
+}
+
+uint16_t Frame::getRow(const int8_t row) const {
+  if (row < 0 || row >= LED_MATRIX_HEIGHT) {
+    return 0;
+  }
+  return readRowBits(row);
+}
+
+void Frame::setRow(const int8_t row, const uint16_t bits) {
+  if (row < 0 || row >= LED_MATRIX_HEIGHT) {
+    return;
+  }
+  writeRowBits(row, bits, ROW_BITS);
+}
+
+/*
+ * After the frame is shifted so that the requested column becomes column 0,
+ * the eight LEDs of the column sit at fixed bits of the data words:
+ *
+ *  row:   0   1   2   3   4   5   6   7
+ *  word:  0   0   0   1   1   1   2   2
+ *  bit:  31  19   7  27  15   3  23  11
+ */
+uint8_t Frame::getColumn(const int8_t col) const {
+  if (col < 0 || col >= LED_MATRIX_WIDTH) {
+    return 0;
+  }
+  const std::array<uint32_t, 3> bits = shiftBits(data, -col);
+  return ((bits[0] >> 24) & 0x80) | ((bits[0] >> 13) & 0x40) |
+         ((bits[0] >> 2) & 0x20) | ((bits[1] >> 23) & 0x10) |
+         ((bits[1] >> 12) & 0x08) | ((bits[1] >> 1) & 0x04) |
+         ((bits[2] >> 22) & 0x02) | ((bits[2] >> 11) & 0x01);
 }
 
-void Frame::invertRect(const Rect &area) {
-  for (int8_t col = area.low_col; col <= area.high_col; col++) {
-    for (int8_t row = area.low_row; row <= area.high_row; row++) {
-      invertLED(row, col);
+void Frame::setColumn(const int8_t col, const uint8_t bits) {
+  if (col < 0 || col >= LED_MATRIX_WIDTH) {
+    return;
+  }
+  const uint32_t b = bits;
+  const std::array<uint32_t, 3> first_col = {
+      ((b & 0x80) << 24) | ((b & 0x40) << 13) | ((b & 0x20) << 2),
+      ((b & 0x10) << 23) | ((b & 0x08) << 12) | ((b & 0x04) << 1),
+      ((b & 0x02) << 22) | ((b & 0x01) << 11)};
+  const std::array<uint32_t, 3> column = shiftBits(first_col, col);
+  const std::array<uint32_t, 3> mask = repeatRow(ROW_TOP_BIT >> col);
+  for (size_t i = 0; i < 3; i++) {
+    data[i] = (data[i] & ~mask[i]) | column[i];
+  }
+}
+
+void Frame::fillRect(const Rect &area, const bool bit) {
+  fillRegion(Region(area), bit);
+}
+
+void Frame::invertRect(const Rect &area) { invertRegion(Region(area)); }
+
+void Frame::fillRegion(const Region &area, const bool bit) {
+  for (size_t i = 0; i < 3; i++) {
+    if (bit) {
+      data[i] |= area.mask.data[i];
+    } else {
+      data[i] &= ~area.mask.data[i];
     }
   }
 }
 
+void Frame::invertRegion(const Region &area) {
+  for (size_t i = 0; i < 3; i++) {
+    data[i] ^= area.mask.data[i];
+  }
+}
+
+void Frame::copyRegion(const Frame &source, const Region &area) {
+  for (size_t i = 0; i < 3; i++) {
+    data[i] = (data[i] & ~area.mask.data[i]) |
+              (source.data[i] & area.mask.data[i]);
+  }
+}
+
 void Frame::drawSprite(const bool *data, const Rect &area) {
   const int8_t width = area.high_col - area.low_col + 1;
   const int8_t height = area.high_row - area.low_row + 1;
-  for (int8_t sprite_col = 0; sprite_col < width; sprite_col++) {
-    for (int8_t sprite_row = 0; sprite_row < height; sprite_row++) {
-      setLED(area.low_row + sprite_row, area.low_col + sprite_col,
-             data[sprite_row * width + sprite_col]);
+  drawSprite(data, width, Rect(0, height - 1, 0, width - 1), area.low_row,
+             area.low_col);
+}
+
+void Frame::drawSprite(const bool *sheet, const size_t stride,
+                       const Rect &source, const int8_t row, const int8_t col) {
+  // Clip the destination against the bounds of the LED matrix. All of the
+  // arithmetic is done in int16_t, since the destination may lie far outside
+  // of the matrix.
+  const int16_t height = source.high_row - source.low_row + 1;
+  const int16_t width = source.high_col - source.low_col + 1;
+  const int16_t first_row = std::max<int16_t>(row, 0);
+  const int16_t last_row =
+      std::min<int16_t>(row + height - 1, LED_MATRIX_HEIGHT - 1);
+  const int16_t first_col = std::max<int16_t>(col, 0);
+  const int16_t last_col =
+      std::min<int16_t>(col + width - 1, LED_MATRIX_WIDTH - 1);
+  if (first_row > last_row || first_col > last_col) {
+    return;
+  }
+
+  // Every visible row is affected in the same columns.
+  const uint16_t mask = rowMask(first_col, last_col);
+
+  for (int16_t dest_row = first_row; dest_row <= last_row; dest_row++) {
+    const bool *src = sheet +
+                      (source.low_row + dest_row - row) * stride +
+                      (source.low_col + first_col - col);
+    uint16_t bits = 0;
+    for (int16_t dest_col = first_col; dest_col <= last_col; dest_col++) {
+      if (*src++) {
+        bits |= ROW_TOP_BIT >> dest_col;
+      }
     }
+    writeRowBits(dest_row, bits, mask);
+  }
+}
+
+Region::Region(const Rect &area) {
+  const int8_t low_row = std::max<int8_t>(area.low_row, 0);
+  const int8_t high_row =
+      std::min<int8_t>(area.high_row, LED_MATRIX_HEIGHT - 1);
+  const int8_t low_col = std::max<int8_t>(area.low_col, 0);
+  const int8_t high_col = std::min<int8_t>(area.high_col, LED_MATRIX_WIDTH - 1);
+  if (low_row > high_row || low_col > high_col) {
+    return;
+  }
+
+  // The rows of the rectangle are the LEDs before the end of its last row,
+  // minus the LEDs before the start of its first row.
+  const std::array<uint32_t, 3> before =
+      Frame::leadingBits(low_row * LED_MATRIX_WIDTH);
+  const std::array<uint32_t, 3> through =
+      Frame::leadingBits((high_row + 1) * LED_MATRIX_WIDTH);
+  const std::array<uint32_t, 3> columns =
+      Frame::repeatRow(Frame::rowMask(low_col, high_col));
+  for (size_t i = 0; i < 3; i++) {
+    mask.data[i] = through[i] & ~before[i] & columns[i];
+  }
+}
+
+Region::Region(const Rect *areas, const size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    *this |= Region(areas[i]);
+  }
+}
+
+Region Region::changedBetween(const Frame &a, const Frame &b) {
+  Region changed;
+  for (size_t i = 0; i < 3; i++) {
+    changed.mask.data[i] = a.data[i] ^ b.data[i];
+  }
+  return changed;
+}
+
+Region Region::operator|(const Region &other) const {
+  Region result = *this;
+  return result |= other;
+}
+
+Region Region::operator&(const Region &other) const {
+  Region result = *this;
+  return result &= other;
+}
+
+Region Region::operator-(const Region &other) const {
+  Region result = *this;
+  return result -= other;
+}
+
+Region &Region::operator|=(const Region &other) {
+  for (size_t i = 0; i < 3; i++) {
+    mask.data[i] |= other.mask.data[i];
   }
+  return *this;
+}
+
+Region &Region::operator&=(const Region &other) {
+  for (size_t i = 0; i < 3; i++) {
+    mask.data[i] &= other.mask.data[i];
+  }
+  return *this;
+}
+
+Region &Region::operator-=(const Region &other) {
+  for (size_t i = 0; i < 3; i++) {
+    mask.data[i] &= ~other.mask.data[i];
+  }
+  return *this;
+}
+
+bool Region::operator==(const Region &other) const {
+  return mask == other.mask;
+}
+
+bool Region::operator!=(const Region &other) const {
+  return mask != other.mask;
+}
+
+bool Region::isEmpty() const { return !mask; }
+
+bool Region::contains(const int8_t row, const int8_t col) const {
+  return mask.getLED(row, col);
+}
+
+bool Region::contains(const Region &other) const {
+  return (other - *this).isEmpty();
 }
 
 const bool DEFAULT_FONT_3x5[39][15] = {
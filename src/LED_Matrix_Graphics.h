@@ -27,6 +27,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <optional>
 
 /**
@@ -60,6 +61,7 @@ constexpr int8_t LED_MATRIX_WIDTH{12};
 /// Represents a rectangular subregion of the LED matrix.
 class Rect {
   friend class Frame;
+  friend class Region;
   int8_t low_row;
   int8_t high_row;
   int8_t low_col;
@@ -131,14 +133,138 @@ public:
   void shiftColumns(int8_t shift);
 };
 
+/// Describes a life-like cellular automaton, such as Conway's Game of Life.
+/**
+ * Both fields are bit sets indexed by the number of live neighbours, so bit n
+ * is responsible for cells that have exactly n live neighbours (0 to 8).
+ */
+struct LifeRule {
+  /// Bit n is set if a dead cell with n live neighbours becomes alive.
+  uint16_t birth;
+
+  /// Bit n is set if a live cell with n live neighbours stays alive.
+  uint16_t survival;
+};
+
+/// The rule of Conway's Game of Life, B3/S23.
+constexpr LifeRule CONWAY_LIFE{1 << 3, (1 << 2) | (1 << 3)};
+
+/// Determines what happens to the LEDs passed to `Frame::setLEDs`.
+enum class PlotMode {
+  /// The LEDs are switched on.
+  Set,
+  /// The LEDs are switched off.
+  Clear,
+  /// The LEDs are inverted. An LED that is listed twice is inverted twice.
+  Toggle,
+};
+
+class Region;
+
 /// Stores the state of the LED matrix.
 class Frame {
+  friend class Region;
+
   std::array<uint32_t, 3> data{0, 0, 0};
 
+  /// A single row packed into the low 12 bits of an integer. Column 0 is
+  /// stored in the highest of those bits, matching the order of the data array.
+  static constexpr uint16_t ROW_BITS{0x0FFF};
+
+  /// The bit that corresponds to column 0 in a packed row.
+  static constexpr uint16_t ROW_TOP_BIT{0x0800};
+
+  /// Returns a packed row mask covering the columns from low_col to high_col.
+  static uint16_t rowMask(const int8_t low_col, const int8_t high_col);
+
+  /// Returns a single row of the frame, packed into 12 bits.
+  /**
+   * @param row The row to read. Must be within the bounds of the matrix.
+   */
+  uint16_t readRowBits(const int8_t row) const;
+
+  /// Overwrites the bits of a packed row that are selected by the mask.
+  /**
+   * @param row  The row to update. Must be within the bounds of the matrix.
+   * @param bits The new state of the row.
+   * @param mask Only the columns that are set in the mask are updated.
+   */
+  void writeRowBits(const int8_t row, const uint16_t bits, const uint16_t mask);
+
+  /// Returns the data of a frame in which every row equals the packed row.
+  /**
+   * The 12-bit pattern is repeated four times in a 48-bit integer. Every data
+   * word then starts at a different phase of that pattern: row 0 begins at the
+   * start of the first word, row 2 is split 8 bits into the second word, and
+   * row 5 is split 4 bits into the third word.
+   */
+  static constexpr std::array<uint32_t, 3> repeatRow(const uint16_t bits) {
+    const uint64_t repeated = bits * 0x001001001001ULL;
+    return {static_cast<uint32_t>(repeated >> 16),
+            static_cast<uint32_t>(repeated >> 8),
+            static_cast<uint32_t>(repeated >> 12)};
+  }
+
+  /// Returns the data of a frame in which the first `count` LEDs are on.
+  /**
+   * The LEDs are counted row-by-row, so `leadingBits(12 * n)` covers the
+   * first n rows of the matrix.
+   */
+  static std::array<uint32_t, 3> leadingBits(const int8_t count);
+
+  /// Moves every bit of the data array by `shift` positions.
+  /**
+   * Positive values move the bits towards the end of the array, which
+   * corresponds to increasing columns and rows. Bits that are shifted past
+   * either end of the array are discarded.
+   */
+  static std::array<uint32_t, 3>
+  shiftBits(const std::array<uint32_t, 3> &bits, const int8_t shift);
+
+  /// Returns a copy of the frame data shifted across rows.
+  /**
+   * @param bits  The frame data.
+   * @param shift How many rows to shift by. Must be within (-8, 8).
+   * @param wrap  If true, the rows that are shifted out of the matrix on one
+   *              side reappear on the other side. Otherwise, they are dropped.
+   */
+  static std::array<uint32_t, 3>
+  shiftedRows(const std::array<uint32_t, 3> &bits, const int8_t shift,
+              const bool wrap);
+
+  /// Returns a copy of the frame data shifted across columns.
+  /**
+   * @param bits  The frame data.
+   * @param shift How many columns to shift by. Must be within (-12, 12).
+   * @param wrap  If true, the columns that are shifted out of the matrix on
+   *              one side reappear on the other side. Otherwise, they are
+   *              dropped.
+   */
+  static std::array<uint32_t, 3>
+  shiftedColumns(const std::array<uint32_t, 3> &bits, const int8_t shift,
+                 const bool wrap);
+
+  /// Returns a copy of the frame data where every lit LED also lights up its
+  /// neighbours.
+  /**
+   * @param bits     The frame data.
+   * @param diagonal If true, uses all eight neighbours. Otherwise, only the
+   *                 four orthogonal neighbours are used.
+   */
+  static std::array<uint32_t, 3> dilated(const std::array<uint32_t, 3> &bits,
+                                         const bool diagonal);
+
 public:
   /// Constructs a frame with all lights off.
   Frame() {}
 
+  /// Constructs a frame from raw frame data.
+  /**
+   * @param raw Pointer to three 32-bit integers in the same format as the
+   *            array returned by `getData`.
+   */
+  explicit Frame(const uint32_t *raw) : data{raw[0], raw[1], raw[2]} {}
+
   /// Returns the frame data as an array of 32-bit integers.
   /**
    * The `loadFrame` function from the Arduino LED Matrix library takes an array
@@ -149,7 +275,7 @@ public:
    *
    * @returns A raw pointer to the data array.
    */
-  const uint32_t *getData();
+  const uint32_t *getData() const;
 
   /// Overlays the two frames.
   /**
@@ -157,7 +283,7 @@ public:
    * @returns A new frame where an LED is on if the same LED is on in either of
    *          the two frames.
    */
-  Frame operator+(const Frame &other);
+  Frame operator+(const Frame &other) const;
 
   /// Compute the intersection of two frames.
   /**
@@ -165,13 +291,180 @@ public:
    * @returns A new frame where an LED is on only if the same LED is on in both
    *          of the two frames.
    */
-  Frame operator&(const Frame &other);
+  Frame operator&(const Frame &other) const;
+
+  /// Compute the difference between two frames.
+  /**
+   * @param other The other frame.
+   * @returns A new frame where an LED is on if it is on in exactly one of the
+   *          two frames.
+   */
+  Frame operator^(const Frame &other) const;
 
   /// Checks if any LEDs are on in the frame.
   /**
    * @returns True, if at least one LED is on in the frame; false, otherwise.
    */
-  explicit operator bool();
+  explicit operator bool() const;
+
+  /// Counts the LEDs that are on in the frame.
+  /**
+   * Each data word is counted with a handful of shifts and masks instead of
+   * checking the LEDs one by one.
+   *
+   * @returns The number of lit LEDs, from 0 to 96.
+   */
+  uint8_t count() const;
+
+  /// Checks if two frames have the same LEDs switched on.
+  /**
+   * @param other The other frame.
+   * @returns True, if every LED has the same state in both frames.
+   */
+  bool operator==(const Frame &other) const;
+
+  /// Checks if two frames differ in at least one LED.
+  /**
+   * @param other The other frame.
+   * @returns True, if at least one LED has a different state in the frames.
+   */
+  bool operator!=(const Frame &other) const;
+
+  /// Computes a 32-bit hash of the frame.
+  /**
+   * Equal frames always have equal hashes. The three data words are mixed
+   * with a couple of multiplications and shifts, so the hash is cheap enough
+   * to compute for every rendered frame.
+   *
+   * @returns The hash of the frame.
+   */
+  uint32_t hash() const;
+
+  /// Shifts the contents of the frame across rows.
+  /**
+   * @param shift How many rows to shift the contents by.
+   *
+   * LEDs that are shifted outside of the matrix are discarded. The rows that
+   * are vacated are switched off.
+   */
+  void shiftRows(const int8_t shift);
+
+  /// Shifts the contents of the frame across columns.
+  /**
+   * @param shift How many columns to shift the contents by.
+   *
+   * LEDs that are shifted outside of the matrix are discarded. The columns
+   * that are vacated are switched off.
+   */
+  void shiftColumns(const int8_t shift);
+
+  /// Advances the frame by one generation of a cellular automaton.
+  /**
+   * @param rule The birth and survival conditions of the automaton.
+   * @param wrap If true, the edges of the matrix wrap around, so that the
+   *             cells in row 0 are neighbours of the cells in row 7 and the
+   *             cells in column 0 are neighbours of the cells in column 11.
+   *             Otherwise, everything outside of the matrix counts as dead.
+   *
+   * Every lit LED is a live cell. The neighbour counts of all 96 cells are
+   * computed at once by adding up shifted copies of the frame with bitwise
+   * full adders, so a generation only takes a few dozen word operations.
+   */
+  void lifeStep(const LifeRule &rule, const bool wrap);
+
+  /// Switches on every LED that is next to a lit LED.
+  /**
+   * All eight neighbours of a lit LED are switched on, including the diagonal
+   * ones.
+   */
+  void dilate();
+
+  /// Switches off every LED that is next to an unlit LED.
+  /**
+   * All eight neighbours are considered, including the diagonal ones. The
+   * area outside of the matrix counts as unlit, so LEDs on the edges of the
+   * matrix are always switched off.
+   */
+  void erode();
+
+  /// Replaces the contents of the frame with their outline.
+  /**
+   * After this call, exactly the LEDs that were off but had a lit neighbour
+   * (including diagonal neighbours) are on. This is the difference between
+   * the dilated frame and the original, and makes text legible on top of
+   * a busy background.
+   */
+  void outline();
+
+  /// Switches on the area of unlit LEDs that contains the given LED.
+  /**
+   * @param row The row of the starting LED.
+   * @param col The column of the starting LED.
+   *
+   * The area spreads to the four orthogonal neighbours only, so a diagonal
+   * line of lit LEDs is enough to enclose it. If the starting LED is already
+   * on or out of bounds, this function does nothing.
+   *
+   * Instead of visiting LEDs one by one, the filled area is repeatedly
+   * dilated within the unlit LEDs until it stops growing.
+   */
+  void floodFill(const int8_t row, const int8_t col);
+
+  /// Returns the state of a single LED.
+  /**
+   * @param row The row in which the LED is located.
+   * @param col The column in which the LED is located.
+   * @returns True, if the LED is on. False, if it is off or the position is
+   *          out of bounds.
+   */
+  bool inline getLED(const int8_t row, const int8_t col) const {
+    const bool valid_row = row < LED_MATRIX_HEIGHT && row >= 0;
+    const bool valid_col = col < LED_MATRIX_WIDTH && col >= 0;
+    if (valid_row && valid_col) {
+      constexpr uint32_t TOP_BIT = 1L << 31;
+      const int8_t pos = row * LED_MATRIX_WIDTH + col;
+      return data[pos >> 5] & (TOP_BIT >> (pos % 32));
+    }
+    return false;
+  }
+
+  /// Returns the state of a whole row.
+  /**
+   * @param row The row to read.
+   * @returns The LEDs of the row packed into the low 12 bits, where column 0
+   *          is stored in the highest of those bits (0x800) and column 11 in
+   *          the lowest (0x001). Returns 0 if the row is out of bounds.
+   */
+  uint16_t getRow(const int8_t row) const;
+
+  /// Sets the state of a whole row.
+  /**
+   * @param row  The row to update.
+   * @param bits The new state of the row, packed the same way as the result of
+   *             `getRow`. Bits above the low 12 are ignored.
+   *
+   * If the row is out of bounds, this function does nothing.
+   */
+  void setRow(const int8_t row, const uint16_t bits);
+
+  /// Returns the state of a whole column.
+  /**
+   * @param col The column to read.
+   * @returns The LEDs of the column packed into 8 bits, where row 0 is stored
+   *          in the highest bit (0x80) and row 7 in the lowest (0x01).
+   *          Returns 0 if the column is out of bounds.
+   */
+  uint8_t getColumn(const int8_t col) const;
+
+  /// Sets the state of a whole column.
+  /**
+   * @param col  The column to update.
+   * @param bits The new state of the column, packed the same way as the result
+   *             of `getColumn`.
+   *
+   * If the column is out of bounds, this function does nothing.
+   */
+  void setColumn(const int8_t col, const uint8_t bits);
 
   /// Sets the state of a single LED.
   /**
@@ -228,6 +521,32 @@ public:
     }
   }
 
+  /// Updates many LEDs at once.
+  /**
+   * @param rows Array with the rows of the LEDs.
+   * @param cols Array with the columns of the LEDs.
+   * @param n    Number of LEDs, which is the length of both arrays.
+   * @param mode Whether the LEDs are switched on, off, or inverted.
+   *
+   * Has the same effect as calling `setLED` or `invertLED` for every LED, but
+   * the changes are collected in three words and applied to the frame once.
+   * LEDs that are out of bounds are skipped.
+   */
+  void setLEDs(const int8_t *rows, const int8_t *cols, const size_t n,
+               const PlotMode mode);
+
+  /// Updates many LEDs at once, given their linear positions.
+  /**
+   * @param positions Array with the positions of the LEDs, where the position
+   *                  of the LED at (row, col) is `row * 12 + col`.
+   * @param n         Number of LEDs in the array.
+   * @param mode      Whether the LEDs are switched on, off, or inverted.
+   *
+   * This is the fastest way to plot points whose positions are computed
+   * ahead of time. Positions from 96 upwards are skipped.
+   */
+  void setLEDs(const uint8_t *positions, const size_t n, const PlotMode mode);
+
   /// Sets the state of all LEDs within a rectangle.
   /**
    * @param area The rectangle of LEDs that will be modified.
@@ -241,6 +560,27 @@ public:
    */
   void invertRect(const Rect &area);
 
+  /// Sets the state of all LEDs within a region.
+  /**
+   * @param area The region of LEDs that will be modified.
+   * @param bit  Determines whether the LEDs are switched on or off.
+   */
+  void fillRegion(const Region &area, const bool bit);
+
+  /// Inverts the state of all LEDs within a region.
+  /**
+   * @param area The region of LEDs that will be flipped.
+   */
+  void invertRegion(const Region &area);
+
+  /// Copies the LEDs within a region from another frame.
+  /**
+   * @param source The frame to copy from.
+   * @param area   The region of LEDs that will be copied. The LEDs outside of
+   *               it keep their state.
+   */
+  void copyRegion(const Frame &source, const Region &area);
+
   /// Draws a sprite to the LED matrix.
   /**
    * @param sprite Pointer to the sprite data.
@@ -259,6 +599,211 @@ public:
    *  `s[8]  s[5] s[10] s[11]`
    */
   void drawSprite(const bool *sprite, const Rect &area);
+
+  /// Draws a part of a larger sprite sheet to the LED matrix.
+  /**
+   * @param sheet  Pointer to the sprite sheet data.
+   * @param stride Number of columns in a single row of the sprite sheet.
+   * @param source Area of the sprite sheet that should be drawn.
+   * @param row    Row of the LED matrix where the top row of `source` is drawn.
+   * @param col    Column of the LED matrix where the leftmost column of
+   *               `source` is drawn.
+   *
+   * The sprite sheet must be laid out sequentially in memory row-by-row, the
+   * same way as the sprites passed to `drawSprite(sprite, area)`. The
+   * destination is allowed to be partially or completely outside of the LED
+   * matrix. It is clipped once before drawing, so the pixels that would not be
+   * visible are never read from the sprite sheet.
+   */
+  void drawSprite(const bool *sheet, const size_t stride, const Rect &source,
+                  const int8_t row, const int8_t col);
+};
+
+/// Represents a set of LEDs of any shape, such as a union of rectangles.
+/**
+ * A region is stored as a mask with one bit per LED, laid out the same way as
+ * the data of a frame. Combining regions and applying them to frames therefore
+ * only takes a few word operations, which makes regions cheap enough to track
+ * the parts of the matrix that changed since the last update. LEDs outside of
+ * the matrix are never part of a region.
+ */
+class Region {
+  friend class Frame;
+  Frame mask{};
+
+  /// Returns a single row of the region, packed the same way as
+  /// `Frame::getRow`.
+  uint16_t rowBits(const int8_t row) const { return mask.readRowBits(row); }
+
+public:
+  /// Constructs an empty region.
+  Region() {}
+
+  /// Constructs a region that covers a rectangle.
+  /**
+   * @param area The rectangle. The parts of it that are outside of the matrix
+   *             are dropped.
+   */
+  Region(const Rect &area);
+
+  /// Constructs a region that covers several rectangles.
+  /**
+   * @param areas Array of rectangles, which may overlap.
+   * @param n     Number of rectangles in the array.
+   */
+  Region(const Rect *areas, const size_t n);
+
+  /// Constructs a region that covers the lit LEDs of a frame.
+  /**
+   * @param lit The frame.
+   */
+  explicit Region(const Frame &lit) : mask(lit) {}
+
+  /// Returns the region where two frames differ.
+  /**
+   * @param a,b The two frames.
+   * @returns A region that contains every LED that is on in one frame and off
+   *          in the other.
+   */
+  static Region changedBetween(const Frame &a, const Frame &b);
+
+  /// Returns the union of two regions.
+  Region operator|(const Region &other) const;
+
+  /// Returns the intersection of two regions.
+  Region operator&(const Region &other) const;
+
+  /// Returns the LEDs of this region that are not part of the other region.
+  Region operator-(const Region &other) const;
+
+  /// Adds the other region to this one.
+  Region &operator|=(const Region &other);
+
+  /// Removes everything outside of the other region from this one.
+  Region &operator&=(const Region &other);
+
+  /// Removes the other region from this one.
+  Region &operator-=(const Region &other);
+
+  /// Checks if two regions contain the same LEDs.
+  bool operator==(const Region &other) const;
+
+  /// Checks if two regions differ in at least one LED.
+  bool operator!=(const Region &other) const;
+
+  /// Checks if the region contains no LEDs.
+  /**
+   * @returns True, if the region is empty; false, otherwise.
+   */
+  bool isEmpty() const;
+
+  /// Checks if the region contains a single LED.
+  /**
+   * @param row The row in which the LED is located.
+   * @param col The column in which the LED is located.
+   * @returns True, if the LED is part of the region. False, if it is not or
+   *          the position is out of bounds.
+   */
+  bool contains(const int8_t row, const int8_t col) const;
+
+  /// Checks if the region contains every LED of another region.
+  /**
+   * @param other The other region. A rectangle can be passed as well, in which
+   *              case only the part of it that is inside the matrix is checked.
+   * @returns True, if the other region is a subset of this one.
+   */
+  bool contains(const Region &other) const;
+
+  /// Calls a function for every horizontal run of LEDs in the region.
+  /**
+   * @param f Function that takes a `Rect`. It is called with single-row
+   *          rectangles, row by row from the top and from left to right within
+   *          every row. Runs are as long as possible, so two runs never touch.
+   */
+  template <typename F> void forEachSpan(F f) const {
+    for (int8_t row = 0; row < LED_MATRIX_HEIGHT; row++) {
+      const uint16_t bits = rowBits(row);
+      int8_t col = 0;
+      while (bits != 0 && col < LED_MATRIX_WIDTH) {
+        if (!(bits & (Frame::ROW_TOP_BIT >> col))) {
+          col++;
+          continue;
+        }
+        const int8_t low_col = col;
+        while (col < LED_MATRIX_WIDTH && (bits & (Frame::ROW_TOP_BIT >> col))) {
+          col++;
+        }
+        f(Rect{row, row, low_col, static_cast<int8_t>(col - 1)});
+      }
+    }
+  }
+
+  /// Calls a function for every rectangle of a decomposition of the region.
+  /**
+   * @param f Function that takes a `Rect`.
+   *
+   * The rectangles do not overlap and together cover the region exactly.
+   * Runs of LEDs that span the same columns in consecutive rows are merged into
+   * one rectangle, so a region constructed from a single rectangle yields that
+   * rectangle again. A rectangle is passed to `f` once its bottom row is known.
+   */
+  template <typename F> void forEachRect(F f) const {
+    // A row of 12 LEDs has at most 6 separate runs.
+    constexpr size_t MAX_RUNS{6};
+    int8_t open_low_row[MAX_RUNS];
+    int8_t open_low_col[MAX_RUNS];
+    int8_t open_high_col[MAX_RUNS];
+    size_t open_count = 0;
+
+    // The extra row past the bottom of the matrix closes every open rectangle.
+    for (int8_t row = 0; row <= LED_MATRIX_HEIGHT; row++) {
+      int8_t low_row[MAX_RUNS];
+      int8_t low_col[MAX_RUNS];
+      int8_t high_col[MAX_RUNS];
+      size_t count = 0;
+
+      const uint16_t bits = row < LED_MATRIX_HEIGHT ? rowBits(row) : 0;
+      int8_t col = 0;
+      while (bits != 0 && col < LED_MATRIX_WIDTH) {
+        if (!(bits & (Frame::ROW_TOP_BIT >> col))) {
+          col++;
+          continue;
+        }
+        low_row[count] = row;
+        low_col[count] = col;
+        while (col < LED_MATRIX_WIDTH && (bits & (Frame::ROW_TOP_BIT >> col))) {
+          col++;
+        }
+        high_col[count] = col - 1;
+        count++;
+      }
+
+      // Runs that continue a rectangle from the previous row extend it. The
+      // others close it.
+      for (size_t i = 0; i < open_count; i++) {
+        bool extended = false;
+        for (size_t j = 0; j < count; j++) {
+          if (low_col[j] == open_low_col[i] &&
+              high_col[j] == open_high_col[i]) {
+            low_row[j] = open_low_row[i];
+            extended = true;
+            break;
+          }
+        }
+        if (!extended) {
+          f(Rect{open_low_row[i], static_cast<int8_t>(row - 1),
+                 open_low_col[i], open_high_col[i]});
+        }
+      }
+
+      for (size_t j = 0; j < count; j++) {
+        open_low_row[j] = low_row[j];
+        open_low_col[j] = low_col[j];
+        open_high_col[j] = high_col[j];
+      }
+      open_count = count;
+    }
+  }
 };
 
 // 3-by-5 letters and digits
@@ -331,3 +876,10 @@ extern const bool DEFAULT_FONT_3x5[39][15];
 */
 extern const bool DEFAULT_FONT_3x4[36][12];
 } // namespace LMG
+
+/// Allows frames to be used as keys in standard unordered containers.
+namespace std {
+template <> struct hash<LMG::Frame> {
+  size_t operator()(const LMG::Frame &frame) const { return frame.hash(); }
+};
+} // namespace std
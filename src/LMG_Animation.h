@@ -0,0 +1,242 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+/*
+ *  Animations are written as a single `step` function that can pause in the
+ *  middle and continue from the same place the next time it is called, using
+ *  the macros below. The place where the function stopped is stored in the
+ *  animation object itself, so an animation never allocates memory and many
+ *  of them can run side by side without `delay()`:
+ *
+ *  class Blink : public LMG::Animation {
+ *    uint8_t i{0};
+ *
+ *    void step() override {
+ *      LMG_ANIMATION_BEGIN();
+ *      for (i = 0; i < 3; i++) {
+ *        LMG_YIELD(lit);
+ *        LMG_AWAIT_MS(250);
+ *        LMG_YIELD(LMG::Frame{});
+ *        LMG_AWAIT_FRAMES(10);
+ *      }
+ *      LMG_ANIMATION_END();
+ *    }
+ *  };
+ *
+ *  Local variables do not survive a pause, so any state that is used across
+ *  LMG_YIELD or LMG_AWAIT_* has to be stored in members (like `i` above), and
+ *  the compiler rejects initialized locals that are still in scope at a pause.
+ *  The macros use the line number to mark the place where the function
+ *  stopped, so there can be at most one of them per line, and they cannot be
+ *  used inside a `switch` statement of their own.
+ */
+
+/// Marks the start of the body of `Animation::step`.
+#define LMG_ANIMATION_BEGIN()                                                  \
+  switch (resume_point) {                                                      \
+  case 0:
+
+/// Marks the end of the body of `Animation::step`. The animation is finished
+/// once it gets here.
+#define LMG_ANIMATION_END()                                                    \
+  }                                                                            \
+  finished = true;                                                             \
+  resume_point = 0
+
+/// Shows a new frame and pauses the animation until the next update.
+#define LMG_YIELD(new_frame)                                                   \
+  do {                                                                         \
+    output = (new_frame);                                                      \
+    resume_point = __LINE__;                                                   \
+    return;                                                                    \
+  case __LINE__:;                                                              \
+  } while (0)
+
+/// Pauses the animation for the given number of updates.
+#define LMG_AWAIT_FRAMES(count)                                                \
+  do {                                                                         \
+    wake_frame = frame_number + (count);                                       \
+    resume_point = __LINE__;                                                   \
+    [[fallthrough]];                                                           \
+  case __LINE__:                                                               \
+    if (static_cast<int32_t>(frame_number - wake_frame) < 0) {                 \
+      return;                                                                  \
+    }                                                                          \
+  } while (0)
+
+/// Pauses the animation until the given time (usually in milliseconds) has
+/// passed on the scheduler's clock.
+#define LMG_AWAIT_MS(duration)                                                 \
+  do {                                                                         \
+    wake_time = now + (duration);                                              \
+    resume_point = __LINE__;                                                   \
+    [[fallthrough]];                                                           \
+  case __LINE__:                                                               \
+    if (static_cast<int32_t>(now - wake_time) < 0) {                           \
+      return;                                                                  \
+    }                                                                          \
+  } while (0)
+
+namespace LMG {
+
+/// Base class for animations that are driven by a Scheduler.
+/**
+ * Derived classes implement `step` with the LMG_ANIMATION_BEGIN,
+ * LMG_ANIMATION_END, LMG_YIELD and LMG_AWAIT_* macros.
+ */
+class Animation {
+  template <size_t N> friend class Scheduler;
+
+protected:
+  /// Where `step` continues from. Zero means the beginning.
+  uint16_t resume_point{0};
+
+  /// Set once the animation reaches LMG_ANIMATION_END.
+  bool finished{false};
+
+  /// The frame that was last produced by LMG_YIELD.
+  Frame output{};
+
+  /// Time of the current update, as passed to `Scheduler::update`.
+  uint32_t now{0};
+
+  /// Number of updates that have been run by the scheduler.
+  uint32_t frame_number{0};
+
+  /// Update at which LMG_AWAIT_FRAMES stops waiting.
+  uint32_t wake_frame{0};
+
+  /// Time at which LMG_AWAIT_MS stops waiting.
+  uint32_t wake_time{0};
+
+  /// Runs the animation until it yields a frame, waits or finishes.
+  virtual void step() = 0;
+
+public:
+  virtual ~Animation() {}
+
+  /// Returns the frame that was last produced by the animation.
+  const Frame &getFrame() const { return output; }
+
+  /// Checks if the animation has run to the end.
+  bool isFinished() const { return finished; }
+
+  /// Makes the animation start over from the beginning on the next update.
+  /**
+   * Members that the animation uses for its own state are not reset.
+   */
+  void restart() {
+    resume_point = 0;
+    finished = false;
+  }
+};
+
+/// Runs several animations side by side on a single core.
+/**
+ * @tparam N Maximum number of animations.
+ *
+ * The scheduler does not read the clock by itself. The sketch calls `update`
+ * with the current time, for example from `loop()`:
+ *
+ *  `matrix.loadFrame(scheduler.update(millis()).getData());`
+ *
+ * This also makes it possible to run animations on a PC with a simulated
+ * clock.
+ */
+template <size_t N> class Scheduler {
+  Animation *animations[N]{};
+  size_t count{0};
+  uint32_t frame_number{0};
+
+public:
+  /// Constructs a scheduler without any animations.
+  Scheduler() {}
+
+  /// Adds an animation to the scheduler.
+  /**
+   * @param animation The animation to run. Must outlive the scheduler, or be
+   *                  removed before it is destroyed.
+   * @returns False, if the scheduler is already full; true, otherwise.
+   */
+  bool add(Animation &animation) {
+    if (count == N) {
+      return false;
+    }
+    animations[count++] = &animation;
+    return true;
+  }
+
+  /// Removes an animation from the scheduler.
+  /**
+   * @param animation The animation to remove.
+   */
+  void remove(const Animation &animation) {
+    for (size_t i = 0; i < count; i++) {
+      if (animations[i] == &animation) {
+        animations[i] = animations[--count];
+        return;
+      }
+    }
+  }
+
+  /// Advances every animation that is not waiting and combines their frames.
+  /**
+   * @param now The current time, usually `millis()`.
+   * @returns The overlay of the latest frames of all animations, including
+   *          the ones that have finished.
+   */
+  Frame update(const uint32_t now) {
+    frame_number++;
+    Frame combined{};
+    for (size_t i = 0; i < count; i++) {
+      Animation &animation = *animations[i];
+      if (!animation.finished) {
+        animation.now = now;
+        animation.frame_number = frame_number;
+        animation.step();
+      }
+      combined = combined + animation.output;
+    }
+    return combined;
+  }
+
+  /// Checks if every animation has run to the end.
+  bool isFinished() const {
+    for (size_t i = 0; i < count; i++) {
+      if (!animations[i]->finished) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace LMG
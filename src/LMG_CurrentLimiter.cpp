@@ -0,0 +1,110 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "LMG_CurrentLimiter.h"
+
+namespace LMG {
+
+namespace {
+
+/// Number of LEDs in the matrix.
+constexpr uint8_t LED_COUNT{LED_MATRIX_HEIGHT * LED_MATRIX_WIDTH};
+
+/// Returns the running parity of the frame data in position order.
+/**
+ * Bit p of the result is set if an odd number of the bits 0 to p are set.
+ * Within a word, the parity is spread towards the less significant bits by
+ * five shifts. The parity of a whole word then flips all bits of the words
+ * after it.
+ */
+std::array<uint32_t, 3> runningParity(const std::array<uint32_t, 3> &bits) {
+  std::array<uint32_t, 3> parity{0, 0, 0};
+  uint32_t carry = 0;
+  for (size_t i = 0; i < 3; i++) {
+    uint32_t word = bits[i];
+    word ^= word >> 1;
+    word ^= word >> 2;
+    word ^= word >> 4;
+    word ^= word >> 8;
+    word ^= word >> 16;
+    parity[i] = word ^ carry;
+
+    // The lowest bit holds the parity of everything up to the end of the word.
+    carry = (parity[i] & 1) ? UINT32_MAX : 0;
+  }
+  return parity;
+}
+
+} // namespace
+
+CurrentLimiter::CurrentLimiter(const uint8_t max_lit,
+                               const bool constant_brightness)
+    : max_lit(max_lit > 0 ? max_lit : 1),
+      constant_brightness(constant_brightness) {
+  if (constant_brightness) {
+    levels = levelsFor(LED_COUNT);
+  }
+}
+
+uint8_t CurrentLimiter::levelsFor(const uint8_t count) const {
+  uint8_t result = 0;
+
+  // Every halving step leaves at most ceil(count / 2) LEDs in a sub-frame.
+  uint8_t largest = count;
+  while (largest > max_lit && result < MAX_LEVELS) {
+    largest = (largest + 1) / 2;
+    result++;
+  }
+  return result;
+}
+
+void CurrentLimiter::setFrame(const Frame &new_frame) {
+  frame = new_frame;
+  if (!constant_brightness) {
+    levels = levelsFor(frame.count());
+  }
+}
+
+Frame CurrentLimiter::subFrame(const uint8_t index) const {
+  const uint32_t *raw = frame.getData();
+  std::array<uint32_t, 3> bits{raw[0], raw[1], raw[2]};
+  for (uint8_t level = 0; level < levels; level++) {
+    // The odd half holds the 1st, 3rd, 5th, ... lit LED, which is one more
+    // than the even half if the count is odd.
+    const std::array<uint32_t, 3> odd = runningParity(bits);
+    const bool take_odd = !(index & (1 << level));
+    for (size_t i = 0; i < 3; i++) {
+      bits[i] &= take_odd ? odd[i] : ~odd[i];
+    }
+  }
+  return Frame{bits.data()};
+}
+
+Frame CurrentLimiter::present() {
+  const Frame result = subFrame(next_index);
+  next_index = (next_index + 1) & (subFrameCount() - 1);
+  return result;
+}
+
+} // namespace LMG
@@ -0,0 +1,122 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Limits how many LEDs are lit at the same time.
+/**
+ * The more LEDs are lit, the more current the matrix draws. A current limiter
+ * takes a frame and splits it into sub-frames that each have at most a given
+ * number of lit LEDs. Showing the sub-frames one after another, faster than
+ * the eye can follow, looks like the original frame:
+ *
+ *  `LMG::CurrentLimiter limiter{24};`
+ *
+ *  `limiter.setFrame(frame);`
+ *  `matrix.loadFrame(limiter.present().getData());`
+ *
+ * Every lit LED appears in exactly one of the sub-frames, so all LEDs of a
+ * frame stay equally bright. The number of sub-frames is a power of two, so
+ * the brightness of a dense frame drops in whole steps of one half.
+ *
+ * The lit LEDs are split with masks rather than one by one. Each halving step
+ * computes the running parity of the lit LEDs in position order, which
+ * separates the 1st, 3rd, 5th, ... lit LED from the 2nd, 4th, 6th, ... one.
+ * The two halves differ in size by at most one LED, and neighbouring lit LEDs
+ * end up in different sub-frames, which keeps flicker to a minimum.
+ */
+class CurrentLimiter {
+  /// Largest number of halving steps. With 128 sub-frames, no sub-frame can
+  /// have more than one lit LED.
+  static constexpr uint8_t MAX_LEVELS{7};
+
+  Frame frame{};
+  uint8_t max_lit;
+  bool constant_brightness;
+  uint8_t levels{0};
+  uint8_t next_index{0};
+
+  /// Returns the number of halving steps that bring `count` lit LEDs within
+  /// the budget.
+  uint8_t levelsFor(const uint8_t count) const;
+
+public:
+  /// Constructs a current limiter.
+  /**
+   * @param max_lit             Maximum number of LEDs that may be lit in a
+   *                            single sub-frame. A budget of 0 is treated like
+   *                            a budget of 1.
+   * @param constant_brightness If true, every frame is split into as many
+   *                            sub-frames as a fully lit frame would need.
+   *                            This costs brightness, but the brightness no
+   *                            longer changes with the number of lit LEDs.
+   *                            Otherwise, frames within the budget are shown at
+   *                            full brightness.
+   */
+  CurrentLimiter(const uint8_t max_lit, const bool constant_brightness = false);
+
+  /// Sets the frame that is shown.
+  /**
+   * @param frame The frame.
+   *
+   * This only counts the lit LEDs. The sub-frames are computed on demand by
+   * `subFrame` and `present`.
+   */
+  void setFrame(const Frame &frame);
+
+  /// Returns the number of sub-frames the current frame is split into.
+  /**
+   * @returns A power of two between 1 and 128.
+   */
+  uint8_t subFrameCount() const { return 1 << levels; }
+
+  /// Returns one of the sub-frames of the current frame.
+  /**
+   * @param index The index of the sub-frame. Only its remainder modulo
+   *              `subFrameCount()` matters.
+   * @returns The sub-frame. It has at most `max_lit` lit LEDs, and together the
+   *          sub-frames contain every lit LED of the frame exactly once.
+   */
+  Frame subFrame(const uint8_t index) const;
+
+  /// Returns the sub-frame that should be shown next.
+  /**
+   * Should be called at a steady rate, ideally at least once per millisecond.
+   * Consecutive calls cycle through the sub-frames. The cycle carries on when
+   * the frame is replaced, so every sub-frame gets its turn even if
+   * `setFrame` is called before every `present`.
+   *
+   * @returns The next sub-frame.
+   */
+  Frame present();
+};
+
+} // namespace LMG
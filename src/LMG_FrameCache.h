@@ -0,0 +1,149 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Remembers the frames that were rendered for recently used keys.
+/**
+ * @tparam Key Type of the value that a frame is rendered from. Must be
+ *             default-constructible and comparable with `==`.
+ * @tparam N   Maximum number of frames that the cache holds.
+ *
+ * When the cache is full, the least recently used frame is replaced. All of
+ * the storage is allocated inside the cache object, so it is suitable for
+ * global variables. For example, a sketch that displays one of 1024 sensor
+ * readings can keep the frames for the readings it shows most often:
+ *
+ *  `LMG::FrameCache<int16_t, 16> cache{};`
+ *  `const LMG::Frame &f = cache.get(reading, drawReading);`
+ *
+ * Lookups scan all of the entries, so N should stay small (tens of frames).
+ */
+template <typename Key, size_t N> class FrameCache {
+  static_assert(N > 0, "FrameCache must have room for at least one frame");
+
+  std::array<Key, N> keys{};
+  std::array<Frame, N> frames{};
+
+  /// Value of `clock` when the entry was last used.
+  std::array<uint32_t, N> last_used{};
+
+  /// Number of entries that hold a frame.
+  size_t count{0};
+
+  /// Increases every time an entry is used.
+  uint32_t clock{0};
+
+  /// Returns the index of the entry for the key, or N if there is none.
+  size_t indexOf(const Key &key) const {
+    for (size_t i = 0; i < count; i++) {
+      if (keys[i] == key) {
+        return i;
+      }
+    }
+    return N;
+  }
+
+public:
+  /// Constructs an empty cache.
+  FrameCache() {}
+
+  /// Looks up the frame for a key.
+  /**
+   * @param key The key to look up.
+   * @returns A pointer to the cached frame, or nullptr if the key is not in
+   *          the cache. The pointer stays valid until the next call to
+   *          `insert`, `get` or `clear`.
+   */
+  const Frame *find(const Key &key) {
+    const size_t index = indexOf(key);
+    if (index == N) {
+      return nullptr;
+    }
+    last_used[index] = ++clock;
+    return &frames[index];
+  }
+
+  /// Stores the frame for a key.
+  /**
+   * @param key   The key that the frame was rendered from.
+   * @param frame The rendered frame.
+   * @returns A reference to the cached copy of the frame.
+   *
+   * Replaces the frame if the key is already in the cache. Otherwise, evicts
+   * the least recently used entry if the cache is full.
+   */
+  const Frame &insert(const Key &key, const Frame &frame) {
+    size_t index = indexOf(key);
+    if (index == N) {
+      if (count < N) {
+        index = count++;
+      } else {
+        index = 0;
+        for (size_t i = 1; i < N; i++) {
+          // Unsigned subtraction keeps the order correct when clock wraps.
+          if (clock - last_used[i] > clock - last_used[index]) {
+            index = i;
+          }
+        }
+      }
+      keys[index] = key;
+    }
+    frames[index] = frame;
+    last_used[index] = ++clock;
+    return frames[index];
+  }
+
+  /// Returns the frame for a key, rendering it if it is not cached.
+  /**
+   * @param key    The key to look up.
+   * @param render A function that takes the key and returns a `Frame`. It is
+   *               only called if the key is not in the cache.
+   * @returns A reference to the cached frame. It stays valid until the next
+   *          call to `insert`, `get` or `clear`.
+   */
+  template <typename Render> const Frame &get(const Key &key, Render render) {
+    const Frame *cached = find(key);
+    if (cached != nullptr) {
+      return *cached;
+    }
+    return insert(key, render(key));
+  }
+
+  /// Removes all frames from the cache.
+  void clear() { count = 0; }
+
+  /// Returns the number of frames in the cache.
+  size_t size() const { return count; }
+};
+
+} // namespace LMG
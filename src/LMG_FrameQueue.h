@@ -0,0 +1,210 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Decides what happens when a frame is pushed into a full FrameQueue.
+enum class OverflowPolicy {
+  /// The oldest queued frame is discarded to make room for the new one.
+  DropOldest,
+  /// The new frame is discarded.
+  DropNewest,
+  /// All queued frames are discarded, so only the new one is left.
+  CoalesceLatest,
+};
+
+/// A bounded queue of frames between one producer and one consumer.
+/**
+ * @tparam N Maximum number of frames in the queue.
+ *
+ * The queue lets the render loop hand frames over to whatever refreshes the
+ * LED matrix without waiting for it. For example, the frames can be presented
+ * from a timer callback while `loop()` keeps polling inputs:
+ *
+ *  `LMG::FrameQueue<4> queue{LMG::OverflowPolicy::CoalesceLatest};`
+ *
+ *  `void refresh() {`
+ *  `  LMG::Frame f{};`
+ *  `  if (queue.pop(f)) {`
+ *  `    matrix.loadFrame(f.getData());`
+ *  `  }`
+ *  `}`
+ *
+ * Exactly one thread (or the main loop) may call `push`, and exactly one
+ * other thread (or interrupt handler) may call `pop`. Neither of them ever
+ * blocks: `push` finishes in a bounded number of steps, and so does `pop`
+ * unless the producer keeps discarding the frame it is reading, in which case
+ * it moves on to a newer frame.
+ *
+ * One slot more than the capacity is allocated, so that the producer never
+ * writes into the slot that the consumer may be copying.
+ */
+template <size_t N> class FrameQueue {
+  static_assert(N > 0, "FrameQueue must have room for at least one frame");
+
+  static constexpr uint32_t SLOTS = N + 1;
+
+  /// The positions count up to this value before wrapping back to zero. It is
+  /// a multiple of SLOTS, so that a position always maps to the same slot.
+  static constexpr uint32_t POSITION_LIMIT = (UINT32_MAX / SLOTS) * SLOTS;
+
+  /// Raw data of the frames. The words are atomic, since the consumer may
+  /// read a slot at the same time as the producer overwrites it after
+  /// discarding its frame.
+  std::atomic<uint32_t> slots[SLOTS][3];
+
+  /// Position of the next frame to be written. Only changed by the producer.
+  std::atomic<uint32_t> head{0};
+
+  /// Position of the next frame to be read. Changed by the consumer, and by
+  /// the producer when it discards queued frames.
+  std::atomic<uint32_t> tail{0};
+
+  OverflowPolicy policy;
+
+  /// Number of frames that were discarded because the queue was full.
+  std::atomic<uint32_t> dropped{0};
+
+  static uint32_t advance(const uint32_t position, const uint32_t by) {
+    const uint32_t next = position + by;
+    return next >= POSITION_LIMIT ? next - POSITION_LIMIT : next;
+  }
+
+  static uint32_t distance(const uint32_t from, const uint32_t to) {
+    return to >= from ? to - from : to + POSITION_LIMIT - from;
+  }
+
+public:
+  /// Constructs an empty queue.
+  /**
+   * @param policy What happens when a frame is pushed into a full queue.
+   */
+  explicit FrameQueue(const OverflowPolicy policy = OverflowPolicy::DropOldest)
+      : policy(policy) {
+    for (auto &slot : slots) {
+      for (auto &word : slot) {
+        word.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  FrameQueue(const FrameQueue &) = delete;
+  FrameQueue &operator=(const FrameQueue &) = delete;
+
+  /// Adds a frame to the back of the queue. May only be called by the
+  /// producer.
+  /**
+   * @param frame The frame to add.
+   * @returns False, if the new frame was discarded due to the DropNewest
+   *          policy; true, otherwise. Frames discarded by the other policies
+   *          are only reported by `droppedCount`.
+   */
+  bool push(const Frame &frame) {
+    const uint32_t write = head.load(std::memory_order_relaxed);
+    uint32_t read = tail.load(std::memory_order_acquire);
+
+    if (distance(read, write) >= N) {
+      if (policy == OverflowPolicy::DropNewest) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      // Discards frames by moving the tail forward. If this fails, the
+      // consumer has just taken a frame, so there is room anyway.
+      const uint32_t discard =
+          policy == OverflowPolicy::DropOldest ? 1 : distance(read, write);
+      if (tail.compare_exchange_strong(read, advance(read, discard),
+                                       std::memory_order_acq_rel)) {
+        dropped.fetch_add(discard, std::memory_order_relaxed);
+      }
+    }
+
+    const uint32_t *raw = frame.getData();
+    auto &slot = slots[write % SLOTS];
+    for (size_t i = 0; i < 3; i++) {
+      slot[i].store(raw[i], std::memory_order_relaxed);
+    }
+    head.store(advance(write, 1), std::memory_order_release);
+    return true;
+  }
+
+  /// Removes the frame at the front of the queue. May only be called by the
+  /// consumer.
+  /**
+   * @param frame Receives the removed frame. Left unchanged if the queue is
+   *              empty.
+   * @returns True, if a frame was removed; false, if the queue was empty.
+   */
+  bool pop(Frame &frame) {
+    uint32_t read = tail.load(std::memory_order_acquire);
+    while (true) {
+      const uint32_t write = head.load(std::memory_order_acquire);
+      if (read == write) {
+        return false;
+      }
+
+      const auto &slot = slots[read % SLOTS];
+      const uint32_t raw[3] = {slot[0].load(std::memory_order_relaxed),
+                               slot[1].load(std::memory_order_relaxed),
+                               slot[2].load(std::memory_order_relaxed)};
+
+      // The copy is only valid if the producer did not discard the frame
+      // while it was being read. Otherwise, `read` is updated to the new tail.
+      if (tail.compare_exchange_weak(read, advance(read, 1),
+                                     std::memory_order_acq_rel,
+                                     std::memory_order_acquire)) {
+        frame = Frame(raw);
+        return true;
+      }
+    }
+  }
+
+  /// Returns the number of frames in the queue.
+  /**
+   * The result is only a snapshot, since the other side may change the queue
+   * at any time.
+   */
+  size_t size() const {
+    return distance(tail.load(std::memory_order_acquire),
+                    head.load(std::memory_order_acquire));
+  }
+
+  /// Checks if the queue has no frames in it.
+  bool empty() const { return size() == 0; }
+
+  /// Returns the total number of frames discarded by the overflow policy.
+  uint32_t droppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace LMG
@@ -0,0 +1,157 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "LMG_NumberDisplay.h"
+
+namespace LMG {
+
+namespace {
+
+/// The digits of DEFAULT_FONT_3x5, packed in the format of the frame data as
+/// if they were drawn at (0,0). The last entry is a blank slot.
+constexpr std::array<uint32_t, 3> GLYPHS[11] = {
+    {0x400A00A0, 0x0A004000, 0x00000000}, // 0
+    {0x400C0040, 0x0400E000, 0x00000000}, // 1
+    {0xC0020040, 0x0800E000, 0x00000000}, // 2
+    {0xC00200C0, 0x0200C000, 0x00000000}, // 3
+    {0xA00A00E0, 0x02002000, 0x00000000}, // 4
+    {0xE00800E0, 0x0200E000, 0x00000000}, // 5
+    {0xE00800E0, 0x0A00E000, 0x00000000}, // 6
+    {0xE0020020, 0x04004000, 0x00000000}, // 7
+    {0xE00A00E0, 0x0A00E000, 0x00000000}, // 8
+    {0xE00A00E0, 0x0200C000, 0x00000000}, // 9
+    {0x00000000, 0x00000000, 0x00000000}, // blank
+};
+
+} // namespace
+
+NumberDisplay::NumberDisplay(const int8_t row, const int8_t *cols,
+                             const uint8_t slot_count)
+    : row(row), slot_count(slot_count < MAX_SLOTS ? slot_count : MAX_SLOTS) {
+  for (uint8_t i = 0; i < this->slot_count; i++) {
+    slot_cols[i] = cols[this->slot_count - 1 - i];
+  }
+  invalidate();
+}
+
+void NumberDisplay::setDecimalPoint(const Rect &area,
+                                    const uint8_t fraction_digits) {
+  point_area = Region(area);
+  this->fraction_digits = fraction_digits;
+  invalidate();
+}
+
+void NumberDisplay::setSign(const Rect &area) {
+  sign_area = Region(area);
+  invalidate();
+}
+
+void NumberDisplay::setLeadingZeros(const bool shown) {
+  leading_zeros = shown;
+  invalidate();
+}
+
+void NumberDisplay::addToDigits(uint8_t amount) {
+  for (uint8_t i = 0; i < slot_count && amount > 0; i++) {
+    const uint8_t sum = digits[i] + amount;
+    digits[i] = sum >= 10 ? sum - 10 : sum;
+    amount = sum >= 10 ? 1 : 0;
+  }
+}
+
+void NumberDisplay::subtractFromDigits(uint8_t amount) {
+  for (uint8_t i = 0; i < slot_count && amount > 0; i++) {
+    const bool borrow = digits[i] < amount;
+    digits[i] = borrow ? digits[i] + 10 - amount : digits[i] - amount;
+    amount = borrow ? 1 : 0;
+  }
+}
+
+void NumberDisplay::setValue(const int32_t new_value) {
+  const bool negative = new_value < 0;
+  const int64_t step = static_cast<int64_t>(new_value) - value;
+  if (negative == (value < 0) && step >= -MAX_STEP && step <= MAX_STEP) {
+    // The magnitude moves in the opposite direction for negative values.
+    const int8_t change = static_cast<int8_t>(negative ? -step : step);
+    if (change > 0) {
+      addToDigits(change);
+    } else {
+      subtractFromDigits(-change);
+    }
+  } else {
+    uint32_t magnitude = negative ? 0 - static_cast<uint32_t>(new_value)
+                                  : static_cast<uint32_t>(new_value);
+    for (uint8_t i = 0; i < slot_count; i++) {
+      digits[i] = magnitude % 10;
+      magnitude /= 10;
+    }
+  }
+  value = new_value;
+}
+
+void NumberDisplay::draw(Frame &frame) {
+  // Digits above the most significant non-zero digit and above the digit
+  // right before the decimal point are leading zeros.
+  int8_t highest_shown = fraction_digits;
+  for (int8_t i = slot_count - 1; i > highest_shown; i--) {
+    if (digits[i] != 0 || leading_zeros) {
+      highest_shown = i;
+      break;
+    }
+  }
+
+  for (uint8_t i = 0; i < slot_count; i++) {
+    const uint8_t glyph = i <= highest_shown ? digits[i] : BLANK;
+    if (glyph == drawn[i]) {
+      continue;
+    }
+    const int8_t col = slot_cols[i];
+    Frame moved{GLYPHS[glyph].data()};
+    moved.shiftRows(row);
+    moved.shiftColumns(col);
+    frame.copyRegion(moved, Region{Rect(row, row + 4, col, col + 2)});
+    drawn[i] = glyph;
+  }
+
+  if (!point_drawn) {
+    frame.fillRegion(point_area, true);
+    point_drawn = true;
+  }
+
+  const uint8_t sign = value < 0;
+  if (sign != sign_drawn) {
+    frame.fillRegion(sign_area, sign);
+    sign_drawn = sign;
+  }
+}
+
+void NumberDisplay::invalidate() {
+  for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+    drawn[i] = UNKNOWN;
+  }
+  point_drawn = false;
+  sign_drawn = UNKNOWN;
+}
+
+} // namespace LMG
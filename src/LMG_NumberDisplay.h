@@ -0,0 +1,159 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Shows a decimal number on the LED matrix with the digits of the 3x5 font.
+/**
+ * The digits are drawn into slots, which are 3 columns wide and 5 rows tall.
+ * The display remembers which glyph every slot currently holds, so `draw` only
+ * touches the slots whose digit changed. Each of those is updated by moving a
+ * pre-packed glyph into place and copying it into the slot with a few word
+ * operations:
+ *
+ *  `const int8_t COLUMNS[] = {0, 4, 9};`
+ *  `LMG::NumberDisplay display{1, COLUMNS, 3};`
+ *
+ *  `display.setValue(42);`
+ *  `display.draw(frame);`
+ *
+ * When the value changes by a small step, which is common for counters and
+ * timers, the digits are incremented or decremented in place instead of being
+ * recomputed with a chain of divisions.
+ */
+class NumberDisplay {
+public:
+  /// Largest number of digit slots, which is as many as fit side by side.
+  static constexpr uint8_t MAX_SLOTS{4};
+
+private:
+  /// Largest change of the value that is applied to the digits in place.
+  static constexpr uint8_t MAX_STEP{9};
+
+  /// Glyph index of a slot that shows nothing.
+  static constexpr uint8_t BLANK{10};
+
+  /// Glyph index of a slot whose contents are not known.
+  static constexpr uint8_t UNKNOWN{0xFF};
+
+  /// Top row of the slots.
+  int8_t row;
+
+  /// Leftmost column of every slot, starting from the least significant
+  /// digit.
+  int8_t slot_cols[MAX_SLOTS]{};
+  uint8_t slot_count;
+
+  Region point_area{};
+  uint8_t fraction_digits{0};
+  Region sign_area{};
+  bool leading_zeros{false};
+
+  int32_t value{0};
+
+  /// Digits of the magnitude of the value, starting from the least
+  /// significant one. Only the lowest `slot_count` digits are kept.
+  uint8_t digits[MAX_SLOTS]{};
+
+  /// The glyph that was last drawn into every slot.
+  uint8_t drawn[MAX_SLOTS];
+  bool point_drawn{false};
+  uint8_t sign_drawn{UNKNOWN};
+
+  /// Adds a single digit to the stored digits, carrying into the higher ones.
+  void addToDigits(uint8_t amount);
+
+  /// Subtracts a single digit from the stored digits, borrowing from the
+  /// higher ones.
+  void subtractFromDigits(uint8_t amount);
+
+public:
+  /// Constructs a number display.
+  /**
+   * @param row        The top row of the digits.
+   * @param cols       Array with the leftmost column of every digit slot, from
+   *                   the most significant digit to the least significant one.
+   * @param slot_count Number of digit slots, at most MAX_SLOTS.
+   *
+   * Every slot must fit inside the matrix, so `row` must be between 0 and 3
+   * and the columns between 0 and 9. The display starts out showing 0.
+   */
+  NumberDisplay(const int8_t row, const int8_t *cols, const uint8_t slot_count);
+
+  /// Adds a decimal point.
+  /**
+   * @param area            The LEDs that make up the decimal point.
+   * @param fraction_digits Number of slots to the right of the decimal point.
+   *
+   * The value is treated as a fixed point number, so with one fraction digit a
+   * value of 25 is shown as 2.5. The digit right before the point is never
+   * blanked.
+   */
+  void setDecimalPoint(const Rect &area, const uint8_t fraction_digits);
+
+  /// Adds a negative sign.
+  /**
+   * @param area The LEDs that are switched on while the value is negative.
+   *
+   * Without a sign, only the magnitude of negative values is shown.
+   */
+  void setSign(const Rect &area);
+
+  /// Chooses whether zeros before the first significant digit are shown.
+  /**
+   * @param shown If true, every slot shows a digit. Otherwise, the leading
+   *              zeros are blanked, which is the default.
+   */
+  void setLeadingZeros(const bool shown);
+
+  /// Sets the value that is shown.
+  /**
+   * @param new_value The value. If it has more digits than there are slots,
+   *                  only the lowest digits are shown.
+   */
+  void setValue(const int32_t new_value);
+
+  /// Returns the value that is shown.
+  int32_t getValue() const { return value; }
+
+  /// Draws the parts of the display that changed since the last call.
+  /**
+   * @param frame The frame to draw into.
+   *
+   * The display assumes that it is always drawn into the same frame and that
+   * nothing else draws over its slots. Otherwise, call `invalidate` first.
+   */
+  void draw(Frame &frame);
+
+  /// Makes the next call to `draw` redraw every part of the display.
+  void invalidate();
+};
+
+} // namespace LMG
@@ -0,0 +1,146 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "LMG_Orientation.h"
+
+#include <algorithm>
+
+namespace LMG {
+
+namespace {
+
+/// Reverses the order of the bits in a word.
+uint32_t reverseBits(uint32_t word) {
+  word = ((word >> 1) & 0x55555555) | ((word & 0x55555555) << 1);
+  word = ((word >> 2) & 0x33333333) | ((word & 0x33333333) << 2);
+  word = ((word >> 4) & 0x0F0F0F0F) | ((word & 0x0F0F0F0F) << 4);
+  word = ((word >> 8) & 0x00FF00FF) | ((word & 0x00FF00FF) << 8);
+  return (word >> 16) | (word << 16);
+}
+
+} // namespace
+
+void PortraitFrame::fillRect(Rect area, const bool bit) {
+  transposed.fillRect(Rect{area.getLowCol(), area.getHighCol(),
+                           area.getLowRow(), area.getHighRow()},
+                      bit);
+}
+
+void PortraitFrame::drawSprite(const bool *sprite, Rect area) {
+  // Clip the area against the bounds of the portrait frame, the same way as
+  // Frame::drawSprite does.
+  const int16_t width = area.getHighCol() - area.getLowCol() + 1;
+  const int8_t first_row = std::max<int8_t>(area.getLowRow(), 0);
+  const int8_t last_row =
+      std::min<int8_t>(area.getHighRow(), PORTRAIT_HEIGHT - 1);
+  const int8_t first_col = std::max<int8_t>(area.getLowCol(), 0);
+  const int8_t last_col =
+      std::min<int8_t>(area.getHighCol(), PORTRAIT_WIDTH - 1);
+  if (first_row > last_row || first_col > last_col) {
+    return;
+  }
+
+  // Every column of the portrait frame is a row of the stored frame, so the
+  // sprite is drawn one column at a time. Rows are packed as described for
+  // Frame::getRow, with portrait row 0 in the highest bit.
+  constexpr uint16_t FIRST_ROW_BIT{0x800};
+  uint16_t mask = 0;
+  for (int8_t row = first_row; row <= last_row; row++) {
+    mask |= FIRST_ROW_BIT >> row;
+  }
+  for (int8_t col = first_col; col <= last_col; col++) {
+    const bool *src = sprite + (first_row - area.getLowRow()) * width +
+                      (col - area.getLowCol());
+    uint16_t bits = 0;
+    for (int8_t row = first_row; row <= last_row; row++) {
+      if (*src) {
+        bits |= FIRST_ROW_BIT >> row;
+      }
+      src += width;
+    }
+    transposed.setRow(col, (transposed.getRow(col) & ~mask) | bits);
+  }
+}
+
+PortraitFrame PortraitFrame::operator+(const PortraitFrame &other) const {
+  PortraitFrame sum{};
+  sum.transposed = transposed + other.transposed;
+  return sum;
+}
+
+Orientation::Orientation(const Rotation rotation, const bool mirror_x,
+                         const bool mirror_y)
+    : rotation(rotation), mirror_x(mirror_x), mirror_y(mirror_y) {}
+
+bool Orientation::isPortrait() const {
+  return rotation == Rotation::Quarter || rotation == Rotation::ThreeQuarters;
+}
+
+Frame Orientation::flipped(const Frame &frame, const bool flip_cols,
+                           const bool flip_rows) {
+  Frame result = frame;
+  if (flip_cols) {
+    // Reversing all 96 bits reverses the columns and the rows at once.
+    const uint32_t *raw = frame.getData();
+    const uint32_t reversed[3] = {reverseBits(raw[2]), reverseBits(raw[1]),
+                                  reverseBits(raw[0])};
+    result = Frame{reversed};
+  }
+  if (flip_cols != flip_rows) {
+    // Puts the rows back in their original order, or reverses them if the
+    // columns were not flipped.
+    const Frame source = result;
+    for (int8_t row = 0; row < LED_MATRIX_HEIGHT; row++) {
+      result.setRow(row, source.getRow(LED_MATRIX_HEIGHT - 1 - row));
+    }
+  }
+  return result;
+}
+
+Frame Orientation::present(const Frame &logical) const {
+  if (isPortrait()) {
+    return Frame{};
+  }
+
+  // A half turn reverses both the rows and the columns, so it is the same as
+  // mirroring in both directions.
+  const bool half = rotation == Rotation::Half;
+  return flipped(logical, mirror_x != half, mirror_y != half);
+}
+
+Frame Orientation::present(const PortraitFrame &logical) const {
+  if (!isPortrait()) {
+    return Frame{};
+  }
+
+  // The portrait frame is stored with rows and columns swapped. Swapping them
+  // is the same as a quarter turn clockwise followed by reversing the
+  // columns, so a quarter turn only has to reverse the columns back, and
+  // three quarters only have to reverse the rows. Mirroring the portrait
+  // columns reverses the stored rows and vice versa.
+  const bool quarter = rotation == Rotation::Quarter;
+  return flipped(logical.transposed, mirror_y != quarter, mirror_x == quarter);
+}
+
+} // namespace LMG
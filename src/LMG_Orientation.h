@@ -0,0 +1,180 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Number of rows of a PortraitFrame.
+constexpr int8_t PORTRAIT_HEIGHT{LED_MATRIX_WIDTH};
+
+/// Number of columns of a PortraitFrame.
+constexpr int8_t PORTRAIT_WIDTH{LED_MATRIX_HEIGHT};
+
+/// Stores a drawing for an LED matrix that is mounted on its side.
+/**
+ * A portrait frame has 12 rows and 8 columns and is meant to be shown through
+ * an Orientation that rotates it by 90 or 270 degrees. The drawing functions
+ * work the same way as the ones of Frame.
+ *
+ * The drawing is kept in a Frame with rows and columns swapped, so the LED at
+ * (row, col) of the portrait frame is stored at (col, row) of the Frame. Every
+ * drawing function maps its coordinates and hands the work to that Frame, and
+ * presenting the drawing only has to flip its rows or columns.
+ */
+class PortraitFrame {
+  friend class Orientation;
+
+  Frame transposed{};
+
+public:
+  /// Constructs a portrait frame with all lights off.
+  PortraitFrame() {}
+
+  /// Sets the state of a single LED.
+  /**
+   * @param row The row in which the LED is located, from 0 to 11.
+   * @param col The column in which the LED is located, from 0 to 7.
+   * @param bit Whether the LED should be on.
+   *
+   * If the LED position is out of bounds, this function does nothing.
+   */
+  void inline setLED(const int8_t row, const int8_t col, const bool bit) {
+    transposed.setLED(col, row, bit);
+  }
+
+  /// Inverts the state of a single LED.
+  /**
+   * @param row The row in which the LED is located, from 0 to 11.
+   * @param col The column in which the LED is located, from 0 to 7.
+   *
+   * If the LED position is out of bounds, this function does nothing.
+   */
+  void inline invertLED(const int8_t row, const int8_t col) {
+    transposed.invertLED(col, row);
+  }
+
+  /// Sets the state of all LEDs within a rectangle.
+  /**
+   * @param area The rectangle of LEDs that will be modified.
+   * @param bit  Determines whether the LEDs are switched on or off.
+   */
+  void fillRect(Rect area, const bool bit);
+
+  /// Draws a sprite to the portrait frame.
+  /**
+   * @param sprite Pointer to the sprite data, laid out row-by-row.
+   * @param area   Area of the portrait frame where the sprite should be drawn.
+   *
+   * See `Frame::drawSprite` for the layout of the sprite. The area may be
+   * partially or completely outside of the portrait frame.
+   */
+  void drawSprite(const bool *sprite, Rect area);
+
+  /// Overlays the two portrait frames.
+  /**
+   * @param other The other portrait frame.
+   * @returns A new portrait frame where an LED is on if the same LED is on in
+   *          either of the two frames.
+   */
+  PortraitFrame operator+(const PortraitFrame &other) const;
+};
+
+/// Maps a drawing in natural coordinates onto the LED matrix as it is
+/// mounted.
+/**
+ * The mapping is applied once, when a frame is presented, so drawing itself
+ * costs the same as without an orientation:
+ *
+ *  `const LMG::Orientation upside_down{LMG::Orientation::Rotation::Half};`
+ *  `matrix.loadFrame(upside_down.present(frame).getData());`
+ *
+ * Mirroring is applied to the drawing before it is rotated. Rotations by 90
+ * and 270 degrees turn the 8x12 matrix into a 12x8 canvas, so they take a
+ * PortraitFrame, while the other orientations take a Frame.
+ *
+ * Every orientation reduces to reversing the order of the columns and the
+ * rows of a frame, which takes a few word operations and one pass over the
+ * rows. For quarter turns this is done on the swapped frame that is stored by
+ * the PortraitFrame.
+ */
+class Orientation {
+public:
+  /// Clockwise rotation of the drawing.
+  enum class Rotation {
+    /// The drawing is shown as is.
+    None,
+    /// The drawing is turned by 90 degrees clockwise.
+    Quarter,
+    /// The drawing is turned by 180 degrees.
+    Half,
+    /// The drawing is turned by 270 degrees clockwise.
+    ThreeQuarters,
+  };
+
+private:
+  Rotation rotation;
+  bool mirror_x;
+  bool mirror_y;
+
+  /// Returns a copy of the frame with its columns and/or rows reversed.
+  static Frame flipped(const Frame &frame, const bool flip_cols,
+                       const bool flip_rows);
+
+public:
+  /// Creates an orientation.
+  /**
+   * @param rotation How the drawing is rotated.
+   * @param mirror_x If true, the columns of the drawing are reversed.
+   * @param mirror_y If true, the rows of the drawing are reversed.
+   */
+  explicit Orientation(const Rotation rotation, const bool mirror_x = false,
+                       const bool mirror_y = false);
+
+  /// Checks if the orientation turns the drawing by a quarter turn, which
+  /// means that it takes a PortraitFrame.
+  bool isPortrait() const;
+
+  /// Maps a frame onto the LED matrix.
+  /**
+   * @param logical The frame as drawn by the sketch.
+   * @returns The frame that should be loaded into the LED matrix. If the
+   *          orientation is a quarter turn, returns an empty frame.
+   */
+  Frame present(const Frame &logical) const;
+
+  /// Maps a portrait frame onto the LED matrix.
+  /**
+   * @param logical The portrait frame as drawn by the sketch.
+   * @returns The frame that should be loaded into the LED matrix. If the
+   *          orientation is not a quarter turn, returns an empty frame.
+   */
+  Frame present(const PortraitFrame &logical) const;
+};
+
+} // namespace LMG
@@ -0,0 +1,194 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "LMG_Stream.h"
+
+namespace LMG {
+
+namespace {
+
+/// Returns byte i of the frame in stream order.
+uint8_t frameByte(const uint32_t *raw, const uint8_t i) {
+  return raw[i / 4] >> (24 - 8 * (i % 4));
+}
+
+/// Appends a byte to a packet and adds it to the checksum.
+void put(uint8_t *out, size_t &size, uint8_t &crc, const uint8_t byte) {
+  out[size++] = byte;
+  crc = streamCrc(crc, byte);
+}
+
+} // namespace
+
+uint8_t streamCrc(uint8_t crc, const uint8_t byte) {
+  crc ^= byte;
+  for (uint8_t bit = 0; bit < 8; bit++) {
+    crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return crc;
+}
+
+size_t encodeKeyframe(const Frame &frame, const uint8_t seq, uint8_t *out) {
+  size_t size = 0;
+  uint8_t crc = 0;
+  out[size++] = STREAM_SYNC;
+  put(out, size, crc, STREAM_KEYFRAME);
+  put(out, size, crc, seq);
+  const uint32_t *raw = frame.getData();
+  for (uint8_t i = 0; i < 12; i++) {
+    put(out, size, crc, frameByte(raw, i));
+  }
+  out[size++] = crc;
+  return size;
+}
+
+size_t encodeDelta(const Frame &previous, const Frame &frame,
+                   const uint8_t seq, uint8_t *out) {
+  const uint32_t *old_raw = previous.getData();
+  const uint32_t *new_raw = frame.getData();
+  const uint32_t changes[3] = {old_raw[0] ^ new_raw[0],
+                               old_raw[1] ^ new_raw[1],
+                               old_raw[2] ^ new_raw[2]};
+  uint16_t bitmap = 0;
+  for (uint8_t i = 0; i < 12; i++) {
+    if (frameByte(changes, i) != 0) {
+      bitmap |= 0x800 >> i;
+    }
+  }
+
+  size_t size = 0;
+  uint8_t crc = 0;
+  out[size++] = STREAM_SYNC;
+  put(out, size, crc, STREAM_DELTA);
+  put(out, size, crc, seq);
+  put(out, size, crc, bitmap >> 8);
+  put(out, size, crc, bitmap & 0xFF);
+  for (uint8_t i = 0; i < 12; i++) {
+    if (bitmap & (0x800 >> i)) {
+      put(out, size, crc, frameByte(changes, i));
+    }
+  }
+  out[size++] = crc;
+  return size;
+}
+
+void StreamDecoder::nextPayloadByte() {
+  while (index < 12 && !(bitmap & (0x800 >> index))) {
+    payload[index++] = 0;
+  }
+  state = index < 12 ? State::Payload : State::Crc;
+}
+
+bool StreamDecoder::apply() {
+  const uint32_t words[3] = {
+      (static_cast<uint32_t>(payload[0]) << 24) | (payload[1] << 16) |
+          (payload[2] << 8) | payload[3],
+      (static_cast<uint32_t>(payload[4]) << 24) | (payload[5] << 16) |
+          (payload[6] << 8) | payload[7],
+      (static_cast<uint32_t>(payload[8]) << 24) | (payload[9] << 16) |
+          (payload[10] << 8) | payload[11]};
+
+  if (type == STREAM_KEYFRAME) {
+    target = Frame{words};
+  } else {
+    if (!synced || seq != static_cast<uint8_t>(last_seq + 1)) {
+      // The delta is relative to a frame that never arrived.
+      synced = false;
+      skipped++;
+      return false;
+    }
+    target = target ^ Frame{words};
+  }
+  synced = true;
+  last_seq = seq;
+  return true;
+}
+
+void StreamDecoder::restart(const uint8_t byte) {
+  crc = 0;
+  state = byte == STREAM_SYNC ? State::Type : State::Sync;
+}
+
+bool StreamDecoder::feed(const uint8_t byte) {
+  switch (state) {
+  case State::Sync:
+    restart(byte);
+    return false;
+  case State::Type:
+    if (byte != STREAM_KEYFRAME && byte != STREAM_DELTA) {
+      // Not a packet after all. The byte may start the real one.
+      restart(byte);
+      return false;
+    }
+    type = byte;
+    crc = streamCrc(crc, byte);
+    state = State::Seq;
+    return false;
+  case State::Seq:
+    seq = byte;
+    crc = streamCrc(crc, byte);
+    index = 0;
+    if (type == STREAM_KEYFRAME) {
+      bitmap = 0xFFF;
+      state = State::Payload;
+    } else {
+      state = State::BitmapHigh;
+    }
+    return false;
+  case State::BitmapHigh:
+    if (byte & 0xF0) {
+      // Only 12 bits are used, so this is a misframed or corrupted packet.
+      crc_errors++;
+      restart(byte);
+      return false;
+    }
+    bitmap = static_cast<uint16_t>(byte) << 8;
+    crc = streamCrc(crc, byte);
+    state = State::BitmapLow;
+    return false;
+  case State::BitmapLow:
+    bitmap = (bitmap | byte) & 0xFFF;
+    crc = streamCrc(crc, byte);
+    nextPayloadByte();
+    return false;
+  case State::Payload:
+    payload[index++] = byte;
+    crc = streamCrc(crc, byte);
+    nextPayloadByte();
+    return false;
+  case State::Crc:
+    if (byte != crc) {
+      // The packet may have been cut short, in which case this byte starts
+      // the next one.
+      crc_errors++;
+      restart(byte);
+      return false;
+    }
+    state = State::Sync;
+    return apply();
+  }
+  return false;
+}
+
+} // namespace LMG
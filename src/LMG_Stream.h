@@ -0,0 +1,177 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+/*
+ *  A compact protocol for streaming frames to the LED matrix over a serial
+ *  connection. Every packet looks like this:
+ *
+ *  | 0xA5 | type | seq | payload ... | crc |
+ *
+ *  - `type` is STREAM_KEYFRAME or STREAM_DELTA.
+ *  - `seq` is a sequence number that increases by one with every packet.
+ *  - A keyframe payload is the 12 bytes of the frame: the words returned by
+ *    `Frame::getData`, each stored most significant byte first.
+ *  - A delta payload is the XOR of the new frame with the previous one, in
+ *    the same byte order. Only the bytes that are not zero are sent. They are
+ *    preceded by two bytes with a 12-bit bitmap of which bytes are present
+ *    (bit 11 of the bitmap stands for byte 0).
+ *  - `crc` is a CRC-8 (polynomial 0x07) of everything after the 0xA5.
+ *
+ *  A delta is only applied if it directly follows the previous packet, so a
+ *  lost packet is bridged by the next keyframe. The sender should send one
+ *  every so often, which also repairs the rare corruption that an 8-bit
+ *  checksum lets through.
+ */
+
+namespace LMG {
+
+/// First byte of every packet.
+constexpr uint8_t STREAM_SYNC{0xA5};
+
+/// Packet type of a keyframe.
+constexpr uint8_t STREAM_KEYFRAME{0x01};
+
+/// Packet type of a delta frame.
+constexpr uint8_t STREAM_DELTA{0x02};
+
+/// Largest possible size of a packet in bytes.
+constexpr size_t STREAM_MAX_PACKET{18};
+
+/// Updates a CRC-8 (polynomial 0x07) with one more byte.
+uint8_t streamCrc(uint8_t crc, const uint8_t byte);
+
+/// Encodes a keyframe packet.
+/**
+ * @param frame The frame to send.
+ * @param seq   The sequence number of the packet.
+ * @param out   Buffer of at least STREAM_MAX_PACKET bytes.
+ * @returns The size of the packet in bytes.
+ */
+size_t encodeKeyframe(const Frame &frame, const uint8_t seq, uint8_t *out);
+
+/// Encodes a delta packet.
+/**
+ * @param previous The frame that was sent in the previous packet.
+ * @param frame    The frame to send.
+ * @param seq      The sequence number of the packet.
+ * @param out      Buffer of at least STREAM_MAX_PACKET bytes.
+ * @returns The size of the packet in bytes, which is between 6 and 18.
+ */
+size_t encodeDelta(const Frame &previous, const Frame &frame,
+                   const uint8_t seq, uint8_t *out);
+
+/// Decodes a stream of packets into a frame, one byte at a time.
+/**
+ * The decoder keeps no copy of the frame, only a 12-byte buffer that stages
+ * the payload of the packet being received. Once the checksum is verified, a
+ * keyframe is written to the target frame and a delta is XORed into it:
+ *
+ *  `LMG::Frame frame{};`
+ *  `LMG::StreamDecoder decoder{frame};`
+ *
+ *  `while (Serial.available() > 0) {`
+ *  `  if (decoder.feed(Serial.read())) {`
+ *  `    matrix.loadFrame(frame.getData());`
+ *  `  }`
+ *  `}`
+ */
+class StreamDecoder {
+  enum class State : uint8_t {
+    Sync,
+    Type,
+    Seq,
+    BitmapHigh,
+    BitmapLow,
+    Payload,
+    Crc,
+  };
+
+  Frame &target;
+
+  State state{State::Sync};
+  uint8_t type{0};
+  uint8_t seq{0};
+  uint8_t crc{0};
+
+  /// Which payload bytes are present, with bit 11 standing for byte 0.
+  uint16_t bitmap{0};
+
+  /// Index of the next payload byte in the 12-byte frame.
+  uint8_t index{0};
+
+  /// Payload bytes received so far, in frame order.
+  uint8_t payload[12]{};
+
+  /// Sequence number of the last packet that was applied.
+  uint8_t last_seq{0};
+
+  /// Whether the target frame is in sync with the sender.
+  bool synced{false};
+
+  uint32_t crc_errors{0};
+  uint32_t skipped{0};
+
+  /// Starts looking for a new packet. If the byte is a sync byte, it is
+  /// treated as the start of that packet.
+  void restart(const uint8_t byte);
+
+  /// Moves to the next payload byte that is present, or to the checksum.
+  void nextPayloadByte();
+
+  /// Applies a packet that passed the checksum.
+  bool apply();
+
+public:
+  /// Creates a decoder that writes into a frame.
+  /**
+   * @param target The frame that receives the decoded packets. Must outlive
+   *               the decoder.
+   */
+  explicit StreamDecoder(Frame &target) : target(target) {}
+
+  /// Processes one byte of the stream.
+  /**
+   * @param byte The byte that was received.
+   * @returns True, if the byte completed a packet and the target frame was
+   *          updated; false, otherwise.
+   */
+  bool feed(const uint8_t byte);
+
+  /// Returns the number of packets that were discarded due to a bad
+  /// checksum or a malformed header.
+  uint32_t crcErrorCount() const { return crc_errors; }
+
+  /// Returns the number of delta packets that were discarded because a
+  /// previous packet was lost.
+  uint32_t skippedCount() const { return skipped; }
+};
+
+} // namespace LMG
@@ -0,0 +1,205 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace LMG {
+
+/// Summary of the latencies recorded by a LatencyTracer.
+struct LatencyStats {
+  /// Number of latencies that the statistics are based on.
+  size_t count;
+
+  /// Shortest latency.
+  uint32_t min;
+
+  /// Median latency.
+  uint32_t p50;
+
+  /// 99th percentile of the latencies.
+  uint32_t p99;
+
+  /// Longest latency.
+  uint32_t max;
+};
+
+/// Measures how long it takes for an input to show up on the LED matrix.
+/**
+ * @tparam PENDING Maximum number of inputs that can be in flight at once.
+ * @tparam SAMPLES Number of latest latencies that are kept for statistics.
+ *
+ * The sketch reports three points in the life of an input: when it is read,
+ * when the state that is drawn has been updated with it, and when a frame is
+ * sent to the matrix. The first frame that is presented after an input was
+ * applied is the first one that reflects it, and the time between reading
+ * the input and presenting that frame is recorded as its latency:
+ *
+ *  `const int8_t id = tracer.input(micros());`
+ *  `game.rotatePiece();`
+ *  `tracer.applied(id);`
+ *  `...`
+ *  `matrix.loadFrame(frame.getData());`
+ *  `tracer.presented(micros());`
+ *
+ * Times are passed in by the caller, so any clock can be used, including a
+ * simulated one. All of the storage is inside the tracer, so it never
+ * allocates memory.
+ */
+template <size_t PENDING, size_t SAMPLES> class LatencyTracer {
+  static_assert(PENDING > 0 && PENDING <= 127,
+                "LatencyTracer can track between 1 and 127 pending inputs");
+  static_assert(SAMPLES > 0, "LatencyTracer must keep at least one sample");
+
+  /// An input that has not been presented yet.
+  struct Pending {
+    uint32_t start;
+    bool in_use;
+    bool applied;
+  };
+
+  Pending pending[PENDING]{};
+
+  /// Ring buffer of the latest latencies.
+  uint32_t samples[SAMPLES]{};
+  size_t next_sample{0};
+  size_t sample_count{0};
+
+  /// Inputs that could not be tracked because all slots were in use.
+  uint32_t overflow{0};
+
+  void record(const uint32_t latency) {
+    samples[next_sample] = latency;
+    next_sample = (next_sample + 1) % SAMPLES;
+    if (sample_count < SAMPLES) {
+      sample_count++;
+    }
+  }
+
+public:
+  /// Constructs a tracer without any inputs or recorded latencies.
+  LatencyTracer() {}
+
+  /// Starts tracking an input.
+  /**
+   * @param now The time at which the input was read.
+   * @returns An identifier to pass to `applied`, or -1 if too many inputs are
+   *          already being tracked.
+   */
+  int8_t input(const uint32_t now) {
+    for (size_t i = 0; i < PENDING; i++) {
+      if (!pending[i].in_use) {
+        pending[i] = {now, true, false};
+        return static_cast<int8_t>(i);
+      }
+    }
+    overflow++;
+    return -1;
+  }
+
+  /// Marks an input as reflected in the state that is drawn.
+  /**
+   * @param id The identifier returned by `input`. Invalid identifiers are
+   *           ignored, so the result of `input` can be passed on unchecked.
+   */
+  void applied(const int8_t id) {
+    if (id >= 0 && static_cast<size_t>(id) < PENDING && pending[id].in_use) {
+      pending[id].applied = true;
+    }
+  }
+
+  /// Records that a frame was sent to the LED matrix.
+  /**
+   * @param now The time at which the frame was presented.
+   *
+   * Every input that was applied before this call is now visible, so its
+   * latency is recorded and it stops being tracked.
+   */
+  void presented(const uint32_t now) {
+    for (auto &input : pending) {
+      if (input.in_use && input.applied) {
+        record(now - input.start);
+        input.in_use = false;
+      }
+    }
+  }
+
+  /// Stops tracking an input that will never be shown, such as a button
+  /// press that was ignored.
+  /**
+   * @param id The identifier returned by `input`.
+   */
+  void cancel(const int8_t id) {
+    if (id >= 0 && static_cast<size_t>(id) < PENDING) {
+      pending[id].in_use = false;
+    }
+  }
+
+  /// Computes statistics of the recorded latencies.
+  /**
+   * @returns The statistics of the latest SAMPLES latencies. If nothing was
+   *          recorded yet, all fields are zero.
+   *
+   * The samples are copied and partially sorted on the stack, so this should
+   * be called when reporting results rather than on every frame.
+   */
+  LatencyStats stats() const {
+    LatencyStats result{sample_count, 0, 0, 0, 0};
+    if (sample_count == 0) {
+      return result;
+    }
+    uint32_t sorted[SAMPLES];
+    std::copy(samples, samples + sample_count, sorted);
+    uint32_t *const end = sorted + sample_count;
+
+    const size_t p50 = (sample_count - 1) * 50 / 100;
+    const size_t p99 = (sample_count - 1) * 99 / 100;
+    std::nth_element(sorted, sorted + p50, end);
+    result.p50 = sorted[p50];
+    std::nth_element(sorted + p50, sorted + p99, end);
+    result.p99 = sorted[p99];
+    result.min = *std::min_element(sorted, sorted + p50 + 1);
+    result.max = *std::max_element(sorted + p99, end);
+    return result;
+  }
+
+  /// Returns the number of inputs that were not tracked because too many
+  /// inputs were pending.
+  uint32_t overflowCount() const { return overflow; }
+
+  /// Forgets all pending inputs and recorded latencies.
+  void reset() {
+    for (auto &input : pending) {
+      input.in_use = false;
+    }
+    next_sample = 0;
+    sample_count = 0;
+    overflow = 0;
+  }
+};
+
+} // namespace LMG
@@ -0,0 +1,184 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#include "LMG_Transition.h"
+
+namespace LMG {
+
+namespace {
+
+/// Number of precomputed masks for Dissolve and Iris, not counting the empty
+/// mask at the start.
+constexpr uint8_t MASK_STEPS{16};
+
+/// Masks for Dissolve, built from a 4x4 Bayer matrix tiled across the LED
+/// matrix. Mask i has the LEDs whose threshold is below i switched on.
+constexpr uint32_t DISSOLVE_MASKS[MASK_STEPS + 1][3] = {
+    {0x00000000, 0x00000000, 0x00000000},
+    {0x88800000, 0x00008880, 0x00000000},
+    {0x88800022, 0x20008880, 0x00222000},
+    {0xAAA00022, 0x2000AAA0, 0x00222000},
+    {0xAAA000AA, 0xA000AAA0, 0x00AAA000},
+    {0xAAA444AA, 0xA000AAA4, 0x44AAA000},
+    {0xAAA444AA, 0xA111AAA4, 0x44AAA111},
+    {0xAAA555AA, 0xA111AAA5, 0x55AAA111},
+    {0xAAA555AA, 0xA555AAA5, 0x55AAA555},
+    {0xEEE555AA, 0xA555EEE5, 0x55AAA555},
+    {0xEEE555BB, 0xB555EEE5, 0x55BBB555},
+    {0xFFF555BB, 0xB555FFF5, 0x55BBB555},
+    {0xFFF555FF, 0xF555FFF5, 0x55FFF555},
+    {0xFFFDDDFF, 0xF555FFFD, 0xDDFFF555},
+    {0xFFFDDDFF, 0xF777FFFD, 0xDDFFF777},
+    {0xFFFFFFFF, 0xF777FFFF, 0xFFFFF777},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+};
+
+/// Masks for Iris. The LEDs of the matrix lie on exactly 16 distinct circles
+/// around its center, and mask i contains the LEDs on the i innermost of them,
+/// so every step grows the iris by one ring.
+constexpr uint32_t IRIS_MASKS[MASK_STEPS + 1][3] = {
+    {0x00000000, 0x00000000, 0x00000000},
+    {0x00000000, 0x00600600, 0x00000000},
+    {0x00000006, 0x00F00F00, 0x60000000},
+    {0x0000000F, 0x00F00F00, 0xF0000000},
+    {0x0000600F, 0x01F81F80, 0xF0060000},
+    {0x0000F01F, 0x81F81F81, 0xF80F0000},
+    {0x0601F81F, 0x83FC3FC1, 0xF81F8060},
+    {0x0F01F83F, 0xC3FC3FC3, 0xFC1F80F0},
+    {0x1F83FC3F, 0xC3FC3FC3, 0xFC3FC1F8},
+    {0x1F83FC3F, 0xC7FE7FE3, 0xFC3FC1F8},
+    {0x1F83FC7F, 0xE7FE7FE7, 0xFE3FC1F8},
+    {0x3FC3FC7F, 0xE7FE7FE7, 0xFE3FC3FC},
+    {0x3FC7FE7F, 0xE7FE7FE7, 0xFE7FE3FC},
+    {0x3FC7FE7F, 0xEFFFFFF7, 0xFE7FE3FC},
+    {0x7FE7FEFF, 0xFFFFFFFF, 0xFF7FE7FE},
+    {0x7FEFFFFF, 0xFFFFFFFF, 0xFFFFF7FE},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+};
+
+} // namespace
+
+Transition::Transition(const Frame &from, const Frame &to, const Effect effect,
+                       const uint32_t duration)
+    : from(from), to(to), effect(effect), duration(duration) {}
+
+Frame Transition::blend(const Frame &a, const Frame &b, const Region &mask) {
+  Frame blended = a;
+  blended.copyRegion(b, mask);
+  return blended;
+}
+
+Frame Transition::at(const uint32_t elapsed) {
+  if (isFinished(elapsed)) {
+    return to;
+  }
+
+  // Converts the elapsed time into a number of discrete steps, where `steps`
+  // is the number of steps in the whole transition.
+  const auto progress = [&](const uint8_t steps) {
+    return static_cast<int8_t>(static_cast<uint64_t>(elapsed) * steps /
+                               duration);
+  };
+
+  constexpr int8_t LAST_ROW = LED_MATRIX_HEIGHT - 1;
+  constexpr int8_t LAST_COL = LED_MATRIX_WIDTH - 1;
+  switch (effect) {
+  case Effect::WipeRight: {
+    const int8_t cols = progress(LED_MATRIX_WIDTH);
+    if (cols == 0) {
+      return from;
+    }
+    return blend(from, to, Region{Rect(0, LAST_ROW, 0, cols - 1)});
+  }
+  case Effect::WipeLeft: {
+    const int8_t cols = progress(LED_MATRIX_WIDTH);
+    if (cols == 0) {
+      return from;
+    }
+    return blend(from, to,
+                 Region{Rect(0, LAST_ROW, LED_MATRIX_WIDTH - cols, LAST_COL)});
+  }
+  case Effect::WipeDown: {
+    const int8_t rows = progress(LED_MATRIX_HEIGHT);
+    if (rows == 0) {
+      return from;
+    }
+    return blend(from, to, Region{Rect(0, rows - 1, 0, LAST_COL)});
+  }
+  case Effect::WipeUp: {
+    const int8_t rows = progress(LED_MATRIX_HEIGHT);
+    return blend(to, from, Region{Rect(0, LAST_ROW - rows, 0, LAST_COL)});
+  }
+  case Effect::SlideLeft:
+  case Effect::SlideRight: {
+    const int8_t cols = progress(LED_MATRIX_WIDTH);
+    if (cols == 0) {
+      return from;
+    }
+    const bool left = effect == Effect::SlideLeft;
+    Frame old_part = from;
+    Frame new_part = to;
+    old_part.shiftColumns(left ? -cols : cols);
+    new_part.shiftColumns(left ? LED_MATRIX_WIDTH - cols
+                               : cols - LED_MATRIX_WIDTH);
+    const Rect new_cols =
+        left ? Rect(0, LAST_ROW, LED_MATRIX_WIDTH - cols, LAST_COL)
+             : Rect(0, LAST_ROW, 0, cols - 1);
+    return blend(old_part, new_part, Region{new_cols});
+  }
+  case Effect::SlideUp:
+  case Effect::SlideDown: {
+    const int8_t rows = progress(LED_MATRIX_HEIGHT);
+    if (rows == 0) {
+      return from;
+    }
+    const bool up = effect == Effect::SlideUp;
+    Frame old_part = from;
+    Frame new_part = to;
+    old_part.shiftRows(up ? -rows : rows);
+    new_part.shiftRows(up ? LED_MATRIX_HEIGHT - rows
+                          : rows - LED_MATRIX_HEIGHT);
+    if (up) {
+      return blend(new_part, old_part,
+                   Region{Rect(0, LAST_ROW - rows, 0, LAST_COL)});
+    }
+    return blend(old_part, new_part, Region{Rect(0, rows - 1, 0, LAST_COL)});
+  }
+  case Effect::Dissolve: {
+    const Frame mask{DISSOLVE_MASKS[progress(MASK_STEPS)]};
+    return blend(from, to, Region{mask});
+  }
+  case Effect::Iris: {
+    const Frame mask{IRIS_MASKS[progress(MASK_STEPS)]};
+    return blend(from, to, Region{mask});
+  }
+  }
+  return to;
+}
+
+bool Transition::isFinished(const uint32_t elapsed) {
+  return elapsed >= duration;
+}
+
+} // namespace LMG
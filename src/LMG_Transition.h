@@ -0,0 +1,109 @@
+/*!
+ *  Copyright 2024 Maxim Sharipov (msharipovr@gmail.com).
+ *
+ *  MIT license, all text above must be included in any redistribution
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to
+ *  deal in the Software without restriction, including without limitation the
+ *  rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ *  sell copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *  IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "LED_Matrix_Graphics.h"
+
+namespace LMG {
+
+/// Animates the switch from one frame to another.
+/**
+ * A transition does not keep track of time by itself. Instead, the caller
+ * passes the time that has elapsed since the start of the transition, which
+ * makes it easy to drive from `millis()` or from any other frame clock:
+ *
+ *  `LMG::Transition t(old_screen, new_screen, Effect::Dissolve, 500);`
+ *  `matrix.loadFrame(t.at(millis() - start).getData());`
+ *
+ * Every intermediate frame is computed with a handful of word operations as
+ * `(from & ~mask) | (to & mask)`, where the mask selects the LEDs that have
+ * already switched to the new frame.
+ */
+class Transition {
+public:
+  /// Available transition effects.
+  enum class Effect {
+    /// The new frame is revealed starting from the leftmost column.
+    WipeRight,
+    /// The new frame is revealed starting from the rightmost column.
+    WipeLeft,
+    /// The new frame is revealed starting from the top row.
+    WipeDown,
+    /// The new frame is revealed starting from the bottom row.
+    WipeUp,
+    /// The new frame pushes the old one out through the left edge.
+    SlideLeft,
+    /// The new frame pushes the old one out through the right edge.
+    SlideRight,
+    /// The new frame pushes the old one out through the top edge.
+    SlideUp,
+    /// The new frame pushes the old one out through the bottom edge.
+    SlideDown,
+    /// The LEDs switch over in an ordered dither pattern.
+    Dissolve,
+    /// The new frame is revealed in a circle that grows from the center.
+    Iris,
+  };
+
+private:
+  Frame from;
+  Frame to;
+  Effect effect;
+  uint32_t duration;
+
+  /// Combines the two frames, taking the LEDs selected by the mask from `b`.
+  static Frame blend(const Frame &a, const Frame &b, const Region &mask);
+
+public:
+  /// Creates a transition between two frames.
+  /**
+   * @param from     The frame that is shown at the start of the transition.
+   * @param to       The frame that is shown at the end of the transition.
+   * @param effect   How the LEDs switch from one frame to the other.
+   * @param duration Length of the transition in the same units that are later
+   *                 passed to `at` (usually milliseconds).
+   */
+  Transition(const Frame &from, const Frame &to, const Effect effect,
+             const uint32_t duration);
+
+  /// Computes the state of the transition at a point in time.
+  /**
+   * @param elapsed Time since the start of the transition.
+   * @returns The intermediate frame. Returns the final frame once `elapsed`
+   *          reaches the duration of the transition.
+   */
+  Frame at(const uint32_t elapsed);
+
+  /// Checks if the transition has finished.
+  /**
+   * @param elapsed Time since the start of the transition.
+   * @returns True, if `elapsed` is at least the duration of the transition.
+   */
+  bool isFinished(const uint32_t elapsed);
+};
+
+} // namespace LMG